@@ -0,0 +1,34 @@
+// Heap allocation accounting
+// linking src/alloc_counter.cpp into a target replaces global operator new/delete with counting versions,
+// so it is opt-in per executable (test_allocations, bench_audio_features) and never part of the Python modules.
+// Only C++ allocations are seen: malloc/fftw_malloc calls made by C libraries are not counted.
+#pragma once
+
+#include <cstdint>
+
+struct AllocStats {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;      // total bytes requested by allocs
+};
+
+AllocStats alloc_stats_thread();  // allocations made by the calling thread
+AllocStats alloc_stats_global();  // allocations made by all threads
+
+// Counts the calling thread's allocations between construction and the call to stats()
+class AllocScope {
+public:
+    AllocScope() : start_(alloc_stats_thread()) {}
+
+    AllocStats stats() const {
+        AllocStats now = alloc_stats_thread();
+        AllocStats d;
+        d.allocs = now.allocs - start_.allocs;
+        d.frees = now.frees - start_.frees;
+        d.bytes = now.bytes - start_.bytes;
+        return d;
+    }
+
+private:
+    AllocStats start_;
+};
@@ -0,0 +1,161 @@
+/*
+ * audiofeat C API: the feature core (audiofeat_core library) without Python or C++ types at the boundary
+ *
+ * Stable ABI rules
+ *   - handles are opaque, structs are only ever extended at the end; audiofeat_config carries its own
+ *     size so older callers keep working when fields are added (fields past their struct_size keep the
+ *     audiofeat_config_init defaults)
+ *   - enum values are fixed numbers, never reordered
+ *   - nothing throws across the boundary: calls return an audiofeat_status and audiofeat_last_error()
+ *     gives the message (per thread)
+ *   - memory the library hands out is released with audiofeat_free()
+ *
+ * LINK
+ *   target_link_libraries(my_service PRIVATE audiofeat_core)
+ *   or: cc my_service.c -Iinclude -Lbuild -laudiofeat_core -lstdc++ -lsndfile -lfftw3 -lpthread -lm
+ */
+#ifndef AUDIOFEAT_H
+#define AUDIOFEAT_H
+
+#include <stddef.h>
+
+/* Windows: the library build defines AUDIOFEAT_BUILDING (exports), users of the static library get
+ * AUDIOFEAT_STATIC from CMake, everyone else imports from the DLL */
+#if defined(_WIN32)
+#  if defined(AUDIOFEAT_STATIC)
+#    define AUDIOFEAT_API
+#  elif defined(AUDIOFEAT_BUILDING)
+#    define AUDIOFEAT_API __declspec(dllexport)
+#  else
+#    define AUDIOFEAT_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define AUDIOFEAT_API __attribute__((visibility("default")))
+#else
+#  define AUDIOFEAT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bumped only when an existing declaration changes incompatibly */
+#define AUDIOFEAT_ABI_VERSION 1
+
+typedef enum {
+    AUDIOFEAT_OK = 0,
+    AUDIOFEAT_ERR_ARGUMENT = 1,   /* invalid config or argument */
+    AUDIOFEAT_ERR_IO = 2,         /* file could not be read */
+    AUDIOFEAT_ERR_MEMORY = 3,
+    AUDIOFEAT_ERR_INTERNAL = 4
+} audiofeat_status;
+
+typedef enum {
+    AUDIOFEAT_PAD_CONSTANT = 0,
+    AUDIOFEAT_PAD_REFLECT = 1,
+    AUDIOFEAT_PAD_EDGE = 2
+} audiofeat_pad_mode;
+
+typedef enum {
+    AUDIOFEAT_WINDOW_RECTANGULAR = 0,
+    AUDIOFEAT_WINDOW_HANN = 1,
+    AUDIOFEAT_WINDOW_HAMMING = 2,
+    AUDIOFEAT_WINDOW_BLACKMAN = 3,
+    AUDIOFEAT_WINDOW_BLACKMAN_HARRIS = 4,
+    AUDIOFEAT_WINDOW_KAISER = 5,
+    AUDIOFEAT_WINDOW_FLATTOP = 6
+} audiofeat_window;
+
+typedef enum {
+    AUDIOFEAT_SPECTRUM_COMPLEX = 0,    /* interleaved re/im, 2 * n_bins values per frame */
+    AUDIOFEAT_SPECTRUM_MAGNITUDE = 1,
+    AUDIOFEAT_SPECTRUM_POWER = 2,
+    AUDIOFEAT_SPECTRUM_LOG_POWER = 3
+} audiofeat_spectrum;
+
+/* feature bits for audiofeat_config.features */
+#define AUDIOFEAT_FEATURE_SPECTRUM (1u << 0)
+#define AUDIOFEAT_FEATURE_CENTROID (1u << 1)
+#define AUDIOFEAT_FEATURE_ROLLOFF  (1u << 2)
+#define AUDIOFEAT_FEATURE_MFCC     (1u << 3)
+#define AUDIOFEAT_FEATURE_RMS      (1u << 4)
+#define AUDIOFEAT_FEATURE_ZCR      (1u << 5)
+#define AUDIOFEAT_FEATURE_ALL      ((1u << 6) - 1)
+
+/* fill with audiofeat_config_init(), then change what you need */
+typedef struct {
+    size_t struct_size;    /* set by audiofeat_config_init */
+    int sample_rate;
+    int n_fft;
+    int win_len;           /* 0 = n_fft */
+    int hop_len;
+    int center;            /* non-zero: frames centered on t * hop_len */
+    int pad_mode;          /* audiofeat_pad_mode */
+    int window;            /* audiofeat_window */
+    int periodic;
+    double kaiser_beta;
+    int spectrum;          /* audiofeat_spectrum */
+    int n_mel;
+    int n_mfcc;
+    double rolloff_pct;
+    unsigned features;     /* AUDIOFEAT_FEATURE_* bits */
+} audiofeat_config;
+
+/* Results of one call, frame-major: row t of spectrum starts at t * n_bins (t * 2 * n_bins when complex).
+ * The arrays belong to the extractor and stay valid until its next process/flush/destroy call;
+ * features that weren't requested are NULL. */
+typedef struct {
+    int n_frames;
+    int n_bins;
+    int n_mfcc;
+    const double* spectrum;
+    const double* centroid;
+    const double* rolloff;
+    const double* mfcc;
+    const float* rms;
+    const float* zcr;
+} audiofeat_result;
+
+typedef struct audiofeat_extractor audiofeat_extractor;
+
+AUDIOFEAT_API int audiofeat_abi_version(void);
+AUDIOFEAT_API const char* audiofeat_last_error(void);  /* "" when the last failing call left no message */
+AUDIOFEAT_API void audiofeat_free(void* p);
+
+/* whole file as interleaved float samples in [-1, 1]; *samples is released with audiofeat_free */
+AUDIOFEAT_API audiofeat_status audiofeat_read_wav(const char* path, float** samples, size_t* n_samples,
+                                                  int* sample_rate, int* channels);
+
+AUDIOFEAT_API float audiofeat_rms(const float* signal, size_t n);
+AUDIOFEAT_API float audiofeat_zcr(const float* signal, size_t n);
+
+AUDIOFEAT_API void audiofeat_config_init(audiofeat_config* config);
+
+AUDIOFEAT_API audiofeat_status audiofeat_extractor_create(const audiofeat_config* config,
+                                                          audiofeat_extractor** extractor);
+AUDIOFEAT_API void audiofeat_extractor_destroy(audiofeat_extractor* extractor);
+AUDIOFEAT_API int audiofeat_extractor_num_bins(const audiofeat_extractor* extractor);
+AUDIOFEAT_API int audiofeat_extractor_num_frames(const audiofeat_extractor* extractor, size_t n_samples);
+
+/* whole clip */
+AUDIOFEAT_API audiofeat_status audiofeat_extractor_process(audiofeat_extractor* extractor, const float* signal,
+                                                           size_t n, audiofeat_result* result);
+/* n_clips clips in one call: clip c is clips[c * stride, c * stride + lengths[c]) (all stride samples when
+ * lengths is NULL). result has n_clips * *frames_per_clip rows, clip c's start at row c * *frames_per_clip;
+ * rows past a clip's own audiofeat_extractor_num_frames() are zero */
+AUDIOFEAT_API audiofeat_status audiofeat_extractor_process_batch(audiofeat_extractor* extractor, const float* clips,
+                                                                 size_t n_clips, size_t stride,
+                                                                 const size_t* lengths, int* frames_per_clip,
+                                                                 audiofeat_result* result);
+/* consecutive blocks of one signal, then flush for the last (right-padded) frames */
+AUDIOFEAT_API audiofeat_status audiofeat_extractor_process_block(audiofeat_extractor* extractor,
+                                                                 const float* block, size_t n,
+                                                                 audiofeat_result* result);
+AUDIOFEAT_API audiofeat_status audiofeat_extractor_flush(audiofeat_extractor* extractor, audiofeat_result* result);
+AUDIOFEAT_API void audiofeat_extractor_reset(audiofeat_extractor* extractor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDIOFEAT_H */
@@ -0,0 +1,73 @@
+// Batch feature extraction over many files cpp header
+// files are decoded and split into frame ranges on a work-stealing pool: each worker has its own deque and
+// its own Extractors, takes its newest task first and steals the oldest task of another worker when idle,
+// so the chunks of one long recording spread over every worker instead of holding one up
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <extractor.hpp>
+#include <feature_cache.hpp>
+
+// One finished file. Multichannel files are averaged to mono; config.sample_rate is replaced by the
+// file's own rate (each worker keeps one Extractor per rate it has seen)
+struct FileFeatures {
+    size_t index = 0;       // position in the paths list
+    std::string path;
+    bool ok = false;
+    std::string error;      // why the file failed when !ok
+    int sample_rate = 0;
+    size_t n_samples = 0;   // per channel
+    FeatureSet features;
+};
+
+struct BatchOptions {
+    int n_workers = 0;              // 0 = hardware threads
+    int chunk_frames = 2048;        // frames per stealable task
+    FeatureCache* cache = nullptr;  // hits skip the extraction (with FileIdentity keys, also the decode)
+};
+
+// Called once per file as soon as it is finished (in completion order, never concurrently).
+// The callback may move the features out; returning false stops the batch after the tasks in flight.
+using FileCallback = std::function<bool(FileFeatures& file)>;
+
+// Blocks until every file is done (or the callback stopped the batch). Throws std::invalid_argument on a bad config
+void extract_files(const std::vector<std::string>& paths, const ExtractorConfig& config,
+                   const BatchOptions& options, const FileCallback& on_file);
+
+// Convenience: all results in paths order
+std::vector<FileFeatures> extract_files(const std::vector<std::string>& paths, const ExtractorConfig& config,
+                                        int n_workers = 0);
+
+// Pull-style batch: runs extract_files in the background and hands finished files out one at a time.
+// At most max_ready finished files wait in memory; workers pause when the consumer falls behind.
+class FileFeatureStream {
+public:
+    FileFeatureStream(const std::vector<std::string>& paths, const ExtractorConfig& config,
+                      const BatchOptions& options = BatchOptions(), size_t max_ready = 4);
+    ~FileFeatureStream();  // stops the batch and joins
+    FileFeatureStream(const FileFeatureStream&) = delete;
+    FileFeatureStream& operator=(const FileFeatureStream&) = delete;
+
+    bool next(FileFeatures& out);  // blocks for the next finished file, false once all are delivered
+    void stop();                   // no new work, next() returns false once the queue is drained
+
+private:
+    bool push(FileFeatures& file);
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable space_cv_;
+    std::deque<FileFeatures> ready_;
+    size_t max_ready_;
+    bool done_;
+    bool stopped_;
+    std::string error_;  // exception from the batch thread, rethrown by next()
+    std::thread runner_;
+};
@@ -0,0 +1,123 @@
+// Stateful feature extractor cpp header
+// built once from an ExtractorConfig, it owns the FFT plan, window, mel/DCT tables and scratch buffers,
+// so calling process() on many short clips only pays for the compute
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <fft_stft.hpp>
+#include <stream_stft.hpp>
+
+// Features an Extractor computes, OR them into ExtractorConfig::features
+enum FeatureFlags : unsigned {
+    FEATURE_SPECTRUM = 1u << 0,  // spectrum in ExtractorConfig::spectrum form, [n_frames][n_bins]
+    FEATURE_CENTROID = 1u << 1,
+    FEATURE_ROLLOFF  = 1u << 2,
+    FEATURE_MFCC     = 1u << 3,  // [n_frames][n_mfcc]
+    FEATURE_RMS      = 1u << 4,
+    FEATURE_ZCR      = 1u << 5,
+    FEATURE_ALL      = (1u << 6) - 1
+};
+
+// "spectrum", "centroid", "rolloff", "mfcc", "rms", "zcr"; throws std::invalid_argument on anything else
+unsigned parse_features(const std::vector<std::string>& names);
+
+struct ExtractorConfig {
+    int sample_rate = 44100;
+    int n_fft = 1024;              // FFT size and frame length
+    int win_len = 0;               // window length <= n_fft, 0 = n_fft (shorter windows are zero-padded)
+    int hop_len = 512;
+    bool center = false;           // pad n_fft / 2 samples on both sides, frame t is centered on t * hop_len
+    PadMode pad_mode = PadMode::Constant;
+    WindowSpec window;             // symmetric Hann by default
+    SpectrumType spectrum = SpectrumType::Magnitude;  // FEATURE_SPECTRUM form and MFCC input (power: log mel power)
+    int n_mel = 26;
+    int n_mfcc = 13;
+    double rolloff_pct = 0.99;
+    unsigned features = FEATURE_ALL;
+};
+
+// 64-bit FNV-1a of every setting that changes the numbers (win_len = 0 and win_len = n_fft hash the same);
+// stored with persisted features so files from different configs are never mixed. Throws like Extractor
+uint64_t config_hash(const ExtractorConfig& config);
+
+// Results for a clip (or a block), frame-major flat arrays: row t of spectrum starts at t * n_bins
+// (t * 2 * n_bins for a complex spectrum, stored as interleaved re/im)
+// only the requested features are filled, the rest stay empty
+struct FeatureSet {
+    int n_frames = 0;
+    int n_bins = 0;
+    int n_mfcc = 0;
+    std::vector<double> spectrum;
+    std::vector<double> centroid;
+    std::vector<double> rolloff;
+    std::vector<double> mfcc;
+    std::vector<float> rms;
+    std::vector<float> zcr;
+};
+
+class Extractor {
+public:
+    explicit Extractor(const ExtractorConfig& config = ExtractorConfig());  // throws std::invalid_argument
+    Extractor(const Extractor&) = delete;
+    Extractor& operator=(const Extractor&) = delete;
+
+    const ExtractorConfig& config() const { return config_; }
+    int numBins() const { return spectrum_.bins(); }
+    int numFrames(size_t n_samples) const;  // frames process() produces for a clip of n_samples
+
+    // whole clip; out is overwritten, its storage is reused when the clip is no longer than the last one
+    void process(const float* signal, size_t n, FeatureSet& out);
+    void process(const double* signal, size_t n, FeatureSet& out);
+    FeatureSet process(const std::vector<float>& signal);
+
+    // many clips in one call (clips x samples, row-major): clip c is clips[c * stride, c * stride + lengths[c]),
+    // every clip stride samples long when lengths is nullptr. Returns the frames per clip F (those of the longest
+    // clip); out holds n_clips * F rows, clip c's at [c * F, (c + 1) * F), zero past numFrames(lengths[c])
+    int processBatch(const float* clips, size_t n_clips, size_t stride, const size_t* lengths, FeatureSet& out);
+
+    // frames [first, first + count) of a whole clip, written to the same rows of out, which allocate()
+    // sized for numFrames(n); lets several extractors with the same config share one long clip
+    void allocate(FeatureSet& out, int n_frames) const;
+    void processRange(const float* signal, size_t n, int first, int count, FeatureSet& out);
+
+    // consecutive blocks of one signal: out holds the frames completed by this block; all blocks plus
+    // flush() give exactly the frames process() gives for the concatenated signal
+    void processBlock(const float* block, size_t n, FeatureSet& out);
+    void processBlock(const double* block, size_t n, FeatureSet& out);
+    void flush(FeatureSet& out);  // end of signal: emit the right-padded frames when centered, then reset()
+    void reset();  // forget carried samples, the next block starts a new signal
+    int64_t framesEmitted() const { return stream_.framesEmitted(); }
+
+private:
+    class BlockRows;  // the frames stream_ completes, written to consecutive rows
+
+    template <typename T> void processFrames(const T* signal, size_t n, const Framing& framing, int first,
+                                             int n_frames, FeatureSet& out, size_t row);
+    template <typename T> void processFrame(const T* frame, FeatureSet& out, size_t row);
+    void zeroRows(FeatureSet& out, size_t begin, size_t end) const;
+    template <typename T> void streamBlock(const T* block, size_t n, FeatureSet& out);
+    const float* timeFrame(const float* frame) { return frame; }
+    const float* timeFrame(const double* frame);
+
+    const float* frameAt(const float* signal, size_t n, const Framing& framing, int t) {
+        return frame_at(signal, n, framing, t, scratch_f_.data());
+    }
+    const double* frameAt(const double* signal, size_t n, const Framing& framing, int t) {
+        return frame_at(signal, n, framing, t, scratch_d_.data());
+    }
+
+    ExtractorConfig config_;
+    Framing framing_;
+    SpectrumProcessor spectrum_;
+    MfccProcessor mfcc_;
+    double bin_hz_;
+    std::vector<double> spectrum_row_;  // used when the spectrum itself isn't returned
+    std::vector<double> magnitude_;     // centroid/rolloff input when the spectrum isn't a magnitude
+    std::vector<float> frame_f_;     // RMS/ZCR input for double signals
+    std::vector<float> scratch_f_;   // padded edge frames
+    std::vector<double> scratch_d_;
+    StreamingStft stream_;           // processBlock carry and centering padding, hands over whole frames
+};
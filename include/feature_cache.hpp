@@ -0,0 +1,76 @@
+// On-disk feature cache cpp header
+// entries are feature files (feature_file.hpp) named <audio key>-<config key>.afeat under dir/<first two hex digits>/.
+// The audio key is a content hash of the decoded mono samples (or, cheaper, the file's identity: device, inode,
+// size and mtime); the config key is config_hash() plus the storage precision.
+// Writers produce a private temp file and rename() it into place, so concurrent processes never see a partial
+// entry (the last identical writer wins). Hits touch the entry's mtime, which is the LRU clock shared by all
+// processes; when this process's running total goes over a limit the directory is rescanned and the least
+// recently used entries are deleted down to 90% of it. POSIX only.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <extractor.hpp>
+
+enum class CacheKeyMode { Content, FileIdentity };
+
+struct FeatureCacheOptions {
+    uint64_t max_bytes = 1ull << 30;  // 1 GiB
+    size_t max_entries = 0;           // 0 = no entry limit
+    CacheKeyMode key = CacheKeyMode::Content;
+    bool float32 = false;             // store double features as float32 (part of the key)
+};
+
+struct FeatureCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t evictions = 0;
+    uint64_t bytes = 0;    // this process's estimate, exact after evict()
+    size_t entries = 0;
+};
+
+// 64-bit content hash of mono samples at a sample rate (xxHash64-style, several GB/s)
+uint64_t audio_hash(const float* samples, size_t n, int sample_rate);
+// device, inode, size and mtime of path plus the path itself; throws std::runtime_error when it can't be stat'ed
+uint64_t file_identity_hash(const std::string& path);
+
+class FeatureCache {
+public:
+    explicit FeatureCache(const std::string& dir, const FeatureCacheOptions& options = FeatureCacheOptions());
+    FeatureCache(const FeatureCache&) = delete;
+    FeatureCache& operator=(const FeatureCache&) = delete;
+
+    const FeatureCacheOptions& options() const { return options_; }
+    uint64_t configKey(const ExtractorConfig& config) const;
+
+    // all thread safe
+    bool lookup(uint64_t audio_key, const ExtractorConfig& config, FeatureSet& out);
+    void store(uint64_t audio_key, const ExtractorConfig& config, int n_bins, const FeatureSet& features);
+
+    // a clip through the cache: out comes from disk or from extractor.process() (then stored); returns true on a hit
+    bool process(Extractor& extractor, const float* signal, size_t n, FeatureSet& out);
+    // a WAV file averaged to mono at its own sample rate (config.sample_rate is replaced), like extract_files
+    bool extractFile(const std::string& path, const ExtractorConfig& config, FeatureSet& out);
+
+    void evict();  // rescan and enforce the limits now
+    void clear();  // delete every entry
+    FeatureCacheStats stats() const;
+
+private:
+    std::string entryPath(uint64_t audio_key, uint64_t config_key) const;
+
+    std::string dir_;
+    FeatureCacheOptions options_;
+    mutable std::mutex mutex_;  // guards bytes_/entries_ and serializes evictions within the process
+    uint64_t bytes_;
+    size_t entries_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> stores_;
+    std::atomic<uint64_t> evictions_;
+    std::atomic<uint64_t> temp_counter_;
+};
@@ -0,0 +1,124 @@
+// Columnar binary feature file cpp header
+//
+// Layout (little-endian):
+//   header (128 bytes)   magic "AFEATS01", config hash, sample rate, n_fft, win_len, hop_len, spectrum type,
+//                        n_bins, n_mfcc, frame and chunk counts, offset of the chunk index
+//   column table         32 bytes per stored feature: name, feature bit, dtype, values per frame
+//   chunks               rows [first, first + n) of every column, one block per column, each block 64-byte aligned
+//   chunk index          per chunk: first frame, frame count, one block offset per column (the frame index)
+// Appending writes new chunks and a new index after the old index and rewrites the header last, so an
+// interrupted append leaves the file as it was.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <extractor.hpp>
+
+enum class StoreType : uint32_t { Float32 = 0, Float64 = 1, Complex64 = 2, Complex128 = 3 };
+
+const char* store_type_descr(StoreType type);  // numpy dtype string, e.g. "<f8"
+size_t store_type_size(StoreType type);
+
+struct FeatureFileColumn {
+    std::string name;     // "spectrum", "centroid", ...
+    unsigned feature;     // FeatureFlags bit
+    StoreType type;
+    int width;            // values per frame (n_bins, n_mfcc or 1)
+};
+
+struct FeatureFileInfo {
+    uint64_t config_hash = 0;
+    int sample_rate = 0;
+    int n_fft = 0;
+    int win_len = 0;
+    int hop_len = 0;
+    bool center = false;
+    SpectrumType spectrum = SpectrumType::Magnitude;
+    unsigned features = 0;
+    int n_bins = 0;
+    int n_mfcc = 0;
+    int chunk_frames = 0;
+    int64_t n_frames = 0;
+    std::vector<FeatureFileColumn> columns;
+};
+
+struct FeatureFileOptions {
+    int chunk_frames = 4096;  // frames buffered before a chunk is written
+    bool float32 = false;     // store double features as float32 (complex spectra as complex64)
+    bool append = false;      // add frames to an existing file written with the same config
+};
+
+class FeatureFileWriter {
+public:
+    // creates (or truncates) path, or opens it for appending (keeping the file's storage types and chunk size);
+    // throws std::invalid_argument when appending with another config, std::runtime_error on I/O errors
+    FeatureFileWriter(const std::string& path, const ExtractorConfig& config, int n_bins,
+                      const FeatureFileOptions& options = FeatureFileOptions());
+    ~FeatureFileWriter();  // close()s, errors ignored
+    FeatureFileWriter(const FeatureFileWriter&) = delete;
+    FeatureFileWriter& operator=(const FeatureFileWriter&) = delete;
+
+    // appends frames.n_frames rows of every stored feature (all must be present in frames)
+    void write(const FeatureSet& frames);
+    void close();  // writes the buffered rows, the index and the header
+    int64_t numFrames() const { return info_.n_frames + pending_frames_; }
+    const FeatureFileInfo& info() const { return info_; }
+
+private:
+    struct Chunk {
+        int64_t first;
+        int64_t n;
+        std::vector<uint64_t> offsets;  // per column
+    };
+
+    void flushChunk();
+    void writeAt(uint64_t offset, const void* data, size_t bytes);
+
+    std::string path_;
+    std::FILE* file_;
+    FeatureFileInfo info_;
+    std::vector<Chunk> chunks_;
+    uint64_t end_;                            // next free byte
+    std::vector<std::vector<char>> pending_;  // rows per column in their stored type
+    int64_t pending_frames_;
+};
+
+// Read-only memory-mapped view of a feature file: nothing but the header and index is read up front
+class FeatureFileReader {
+public:
+    explicit FeatureFileReader(const std::string& path);  // throws std::runtime_error on a missing or corrupt file
+    ~FeatureFileReader();
+    FeatureFileReader(const FeatureFileReader&) = delete;
+    FeatureFileReader& operator=(const FeatureFileReader&) = delete;
+
+    const FeatureFileInfo& info() const { return info_; }
+    int64_t numFrames() const { return info_.n_frames; }
+    int column(const std::string& name) const;  // index into info().columns, -1 if not stored
+
+    // rows [start, stop) of a column in place when they lie in one chunk, nullptr when they span chunks
+    const void* view(int column, int64_t start, int64_t stop) const;
+    // rows [start, stop) copied to out (any range); out holds (stop - start) * width values of the stored type
+    void read(int column, int64_t start, int64_t stop, void* out) const;
+    // every frame of every stored feature as a FeatureSet (float32 columns widened back to double)
+    void readFeatures(FeatureSet& out) const;
+    // first frame of every chunk, plus numFrames() at the end
+    std::vector<int64_t> chunkBoundaries() const;
+
+private:
+    size_t chunkOf(int64_t frame) const;
+    const char* block(size_t chunk, int column) const;
+    void checkRange(int column, int64_t start, int64_t stop) const;
+
+    const char* data_;
+    size_t size_;
+    FeatureFileInfo info_;
+    std::vector<int64_t> first_;              // per chunk
+    std::vector<int64_t> count_;
+    std::vector<std::vector<uint64_t>> offsets_;
+#if defined(_WIN32)
+    std::vector<char> buffer_;  // no mmap: the file is read whole
+#endif
+};
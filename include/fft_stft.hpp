@@ -3,6 +3,175 @@
 
 #include <vector>
 #include <complex>
+#include <mutex>
+#include <string>
+#include <fftw3.h>
+#include <window_functions.hpp>
+
+// FFTW planner is not thread safe: hold this lock while creating or destroying plans
+std::mutex& fftw_planner_mutex();
+
+// Cached real-to-complex FFT plan with its own aligned in/out buffers
+// plan once, then fill input(), execute() and read output() for every frame
+class FftPlan {
+public:
+    explicit FftPlan(int n);
+    ~FftPlan();
+    FftPlan(const FftPlan&) = delete;
+    FftPlan& operator=(const FftPlan&) = delete;
+
+    int size() const { return n_; }
+    int bins() const { return n_ / 2 + 1; }
+    double* input() { return in_; }
+    const fftw_complex* output() const { return out_; }
+    void execute() { fftw_execute(plan_); }
+
+private:
+    int n_;
+    double* in_;
+    fftw_complex* out_;
+    fftw_plan plan_;
+};
+
+// Cached complex-to-real inverse plan, the counterpart of FftPlan
+// unnormalized like FFTW: output() is n times the signal, and execute() overwrites input()
+class InverseFftPlan {
+public:
+    explicit InverseFftPlan(int n);
+    ~InverseFftPlan();
+    InverseFftPlan(const InverseFftPlan&) = delete;
+    InverseFftPlan& operator=(const InverseFftPlan&) = delete;
+
+    int size() const { return n_; }
+    int bins() const { return n_ / 2 + 1; }
+    fftw_complex* input() { return in_; }
+    const double* output() const { return out_; }
+    void execute() { fftw_execute(plan_); }
+
+private:
+    int n_;
+    fftw_complex* in_;
+    double* out_;
+    fftw_plan plan_;
+};
+
+// Hann window of length win_len (symmetric, from the window cache)
+std::vector<double> hann_window(int win_len);
+
+// Triangular mel filterbank, returns [num_mel_filters][fft_size / 2 + 1]
+std::vector<std::vector<double>> mel_filterbank(
+    int sample_rate, int fft_size, int num_mel_filters);
+
+// Framing: frame t starts at t * hop_len, or t * hop_len - n_fft / 2 when centered.
+// Samples outside the signal are produced by the pad mode when a frame is read (frame_at),
+// so centered framing never materializes a padded copy of the signal.
+enum class PadMode { Constant, Reflect, Edge };
+
+PadMode parse_pad_mode(const std::string& name);  // "constant", "reflect" or "edge", throws std::invalid_argument
+const char* pad_mode_name(PadMode mode);
+
+// signal index the out-of-range position i maps to (numpy.pad semantics), -1 for a zero sample
+long pad_index(long i, size_t n, PadMode mode);
+
+struct Framing {
+    int n_fft;
+    int hop_len;
+    bool center;
+    PadMode pad_mode;
+
+    long padding() const { return center ? n_fft / 2 : 0; }
+    long start(int t) const { return static_cast<long>(t) * hop_len - padding(); }
+    int numFrames(size_t n) const;
+};
+
+// frame t of signal[0, n): a pointer into the signal when the frame lies inside it,
+// otherwise scratch (n_fft values) filled with the padded samples
+template <typename T>
+const T* frame_at(const T* signal, size_t n, const Framing& framing, int t, T* scratch) {
+    long start = framing.start(t);
+    if (start >= 0 && start + framing.n_fft <= static_cast<long>(n)) return signal + start;
+    for (int i = 0; i < framing.n_fft; ++i) {
+        long j = start + i;
+        if (j < 0 || j >= static_cast<long>(n)) j = pad_index(j, n, framing.pad_mode);
+        scratch[i] = j < 0 ? T(0) : signal[j];
+    }
+    return scratch;
+}
+
+// What a spectrum frame holds: Complex is interleaved re/im (2 * bins values), Power is |X|^2 (no sqrt),
+// LogPower is 10 * log10(max(|X|^2, 1e-10)) in dB
+enum class SpectrumType { Complex, Magnitude, Power, LogPower };
+
+SpectrumType parse_spectrum_type(const std::string& name);  // "complex", "magnitude", "power" or "log_power"
+const char* spectrum_type_name(SpectrumType type);
+inline int spectrum_values(SpectrumType type, int bins) { return type == SpectrumType::Complex ? 2 * bins : bins; }
+
+// Per-frame kernels: everything is precomputed in the constructor so processing a frame never allocates.
+// compute_stft / compute_mfcc and the streaming engine are built on these.
+
+// Windowed magnitude spectrum of one n_fft frame (symmetric Hann unless another window is given)
+// a window shorter than n_fft sits in the middle of the frame, the FFT input is zero around it
+class SpectrumProcessor {
+public:
+    explicit SpectrumProcessor(int win_len, int n_fft = 0,  // n_fft = 0: same as win_len
+                               const WindowSpec& window = WindowSpec());
+
+    int winLen() const { return window_->size(); }
+    int fftSize() const { return fft_.size(); }
+    int bins() const { return fft_.bins(); }
+    void magnitude(const double* frame, double* out);  // frame has fftSize() samples, out has bins() values
+    void magnitude(const float* frame, double* out);
+    void complex(const double* frame, std::complex<double>* out);  // the spectrum itself, bins() values
+    void complex(const float* frame, std::complex<double>* out);
+    void complex(const double* frame, std::complex<float>* out);
+    // any SpectrumType, out has spectrum_values(type, bins()) values
+    void compute(const double* frame, SpectrumType type, double* out);
+    void compute(const float* frame, SpectrumType type, double* out);
+    // the last computed frame again in another form (no second FFT)
+    void convert(SpectrumType type, double* out) const;
+    const WindowTable& window() const { return *window_; }
+
+private:
+    template <typename T> void applyWindow(const T* frame);
+    void transform();  // FFT of the windowed frame
+
+    std::shared_ptr<const WindowTable> window_;
+    int offset_;  // (n_fft - win_len) / 2
+    FftPlan fft_;
+};
+
+// Log mel energies and their DCT for one spectrum frame (mel filterbank stored sparsely)
+// input says what the frames hold: magnitude frames give log mel magnitudes (the original behaviour),
+// power frames log mel power; complex and log-power frames are turned back into power first
+class MfccProcessor {
+public:
+    MfccProcessor(int sample_rate, int fft_size, int num_mel_filters = 26, int num_mfcc = 13,
+                  SpectrumType input = SpectrumType::Magnitude);
+
+    int numMel() const { return n_mel_; }
+    int numMfcc() const { return n_mfcc_; }
+    SpectrumType input() const { return input_; }
+    void melEnergies(const double* spectrum, double* mel_out);  // filterbank sums before the log
+    void logMel(const double* spectrum, double* mel_out);   // mel_out has numMel() values
+    void compute(const double* spectrum, double* mfcc_out); // mfcc_out has numMfcc() values
+
+private:
+    int n_mel_;
+    int n_mfcc_;
+    SpectrumType input_;
+    std::vector<double> power_;                // complex / log-power input converted to power
+    std::vector<int> start_;                   // first non-zero bin of each filter
+    std::vector<std::vector<double>> weights_; // non-zero weights from start_
+    std::vector<double> dct_;                  // [n_mfcc][n_mel] cosine table
+    std::vector<double> mel_;                  // scratch
+};
+
+// Row order of 2-D results: TimeMajor is [n_frames][n] (row t is frame t), FrequencyMajor is [n][n_frames]
+// (row k is bin / coefficient k over time, interleaved re/im pairs per frame for a complex spectrum)
+enum class Layout { TimeMajor, FrequencyMajor };
+
+Layout parse_layout(const std::string& name);  // "time" or "frequency", throws std::invalid_argument
+const char* layout_name(Layout layout);
 
 // FFT
 std::vector<std::complex<double>> compute_fft(
@@ -14,21 +183,69 @@ std::vector<std::vector<double>> compute_stft(
     int win_len, 
     int hop_len);
 
+// n_fft >= win_len zero-pads each windowed frame, center pads n_fft / 2 samples on both sides
+// (pad_mode samples, read virtually) so frame t is centered on sample t * hop_len; every STFT function
+// throws std::invalid_argument unless win_len > 0, hop_len > 0 and n_fft (0 = win_len) >= win_len
+std::vector<std::vector<double>> compute_stft(
+    const std::vector<double>& signal,
+    int win_len,
+    int hop_len,
+    int n_fft,
+    bool center = false,
+    PadMode pad_mode = PadMode::Constant,
+    const WindowSpec& window = WindowSpec(),
+    SpectrumType spectrum = SpectrumType::Magnitude,  // rows have spectrum_values(spectrum, bins) values
+    Layout layout = Layout::TimeMajor);
+
+// Complex STFT, same framing as compute_stft: [n_frames][n_fft / 2 + 1]
+std::vector<std::vector<std::complex<double>>> compute_stft_complex(
+    const std::vector<double>& signal,
+    int win_len,
+    int hop_len,
+    int n_fft = 0,
+    bool center = false,
+    PadMode pad_mode = PadMode::Constant,
+    const WindowSpec& window = WindowSpec());
+
+// Caller-buffer versions for loops that must not allocate: results go to out, row-major, which holds
+// stft_num_frames() rows of spectrum_values(spectrum, n_fft / 2 + 1) values (STFT), n_frames values
+// (centroid, rolloff) or n_frames rows of n_mfcc values (MFCC), transposed for Layout::FrequencyMajor
+// (compute_mfcc then also reads its spectrogram frequency-major). The plan, window and filterbank of the
+// last call are kept per thread, so repeated calls with the same settings allocate nothing.
+int stft_num_frames(size_t n, int win_len, int hop_len, int n_fft = 0, bool center = false);
+void compute_stft(const double* signal, size_t n, int win_len, int hop_len, int n_fft, bool center,
+                  PadMode pad_mode, const WindowSpec& window, SpectrumType spectrum, double* out,
+                  Layout layout = Layout::TimeMajor);
+void compute_stft(const float* signal, size_t n, int win_len, int hop_len, int n_fft, bool center,
+                  PadMode pad_mode, const WindowSpec& window, SpectrumType spectrum, double* out,
+                  Layout layout = Layout::TimeMajor);
+void compute_spectral_centroid(const double* spectrogram, int n_frames, int bins, int sample_rate, int fft_size,
+                               double* out);
+void compute_spectral_rolloff(const double* spectrogram, int n_frames, int bins, int sample_rate, int fft_size,
+                              double rolloff_pct, double* out);
+void compute_mfcc(const double* spectrogram, int n_frames, int sample_rate, int fft_size, int n_mel, int n_mfcc,
+                  SpectrumType spectrum, double* out,  // rows of fft_size / 2 + 1 bins (2x when complex)
+                  Layout layout = Layout::TimeMajor);
+
 // Spectral Centroid
+double spectral_centroid(const double* magnitude, int bins, double bin_hz);  // one frame
 std::vector<double> compute_spectral_centroid(
     const std::vector<std::vector<double>>& spectrogram, 
     int sample_rate, 
     int fft_size);
 
 // Spectral Rolloff
+double spectral_rolloff(const double* magnitude, int bins, double bin_hz, double rolloff_pct);  // one frame
 std::vector<double> compute_spectral_rolloff(
     const std::vector<std::vector<double>>& spectrogram,
     int sample_rate, int fft_size,
     double rolloff_pct = 0.99);
 //    double rolloff_pct = 0.99);
 
-// MFCCs
+// MFCCs, throws std::invalid_argument when the rows do not hold fft_size / 2 + 1 bins per frame
 std::vector<std::vector<double>> compute_mfcc(
     const std::vector<std::vector<double>>& spectrogram,
-    int sample_rate, int fft_size, int num_mel_filters = 26, int num_mfcc=13);
+    int sample_rate, int fft_size, int num_mel_filters = 26, int num_mfcc=13,
+    SpectrumType spectrum = SpectrumType::Magnitude,  // what the spectrogram rows hold
+    Layout layout = Layout::TimeMajor);               // of the spectrogram and the result
 //    int sample_rate, int fft_size, int num_mel_filters = 26, int num_mfcc = 13);
\ No newline at end of file
@@ -0,0 +1,67 @@
+// Pipelined feature extraction for one long file cpp header
+// reader thread (libsndfile) -> feature workers -> writer thread, connected by lock-free SPSC rings.
+// The reader cuts the signal into segments of whole frames, each carrying the n_fft - hop_len overlap
+// (and the centered padding at the ends), so workers need no state and the output equals Extractor::process
+// on the whole file. Segment buffers come from a fixed pool: memory does not grow with the file.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include <extractor.hpp>
+
+struct PipelineOptions {
+    int segment_frames = 1024;  // frames per segment (per worker task)
+    int n_workers = 2;
+    int queue_depth = 2;        // segments in flight per worker
+    int read_frames = 16384;    // sample frames per libsndfile read
+};
+
+struct PipelineStats {
+    int sample_rate = 0;
+    int channels = 0;
+    int64_t n_samples = 0;      // per channel
+    int64_t n_frames = 0;
+    int64_t segments = 0;
+    size_t buffer_bytes = 0;    // segment pool (samples and feature rows) plus reader buffers, fixed per config
+};
+
+// Runs on the writer thread, in frame order: rows [0, frames.n_frames) of frames are frames
+// [first_frame, first_frame + frames.n_frames) of the file. Must not keep references to frames.
+using FrameSink = std::function<void(const FeatureSet& frames, int64_t first_frame)>;
+
+// Features of a whole WAV file (averaged to mono, at the file's own sample rate), streamed into sink.
+// Throws std::invalid_argument on a bad config or options, std::runtime_error when the file can't be read;
+// an exception thrown by sink stops the pipeline and is rethrown here.
+PipelineStats extract_file_pipelined(const std::string& path, const ExtractorConfig& config,
+                                     const PipelineOptions& options, const FrameSink& sink);
+
+// Sink writing each requested feature to <dir>/<feature>.npy (little-endian, frame-major);
+// the row count in the headers is patched by close()
+class NpyFeatureWriter {
+public:
+    NpyFeatureWriter(const std::string& dir, const ExtractorConfig& config, int n_bins);
+    ~NpyFeatureWriter();  // close()s, errors ignored
+    NpyFeatureWriter(const NpyFeatureWriter&) = delete;
+    NpyFeatureWriter& operator=(const NpyFeatureWriter&) = delete;
+
+    void write(const FeatureSet& frames, int64_t first_frame);
+    void close();  // throws std::runtime_error when a file can't be finished
+    std::vector<std::string> paths() const;
+
+private:
+    struct Column {
+        unsigned feature;    // FeatureFlags bit
+        std::string path;
+        std::FILE* file;
+        std::string descr;   // numpy dtype, e.g. "<f8"
+        int64_t width;       // values per row, 0 for a 1-D column
+    };
+
+    void writeHeader(Column& column, int64_t rows);
+
+    std::vector<Column> columns_;
+    int64_t rows_;
+};
@@ -0,0 +1,62 @@
+// Inverse STFT / overlap-add resynthesis cpp header
+// frames produced by compute_stft_complex (or SpectrumProcessor::complex) go back through a c2r plan,
+// are multiplied by the synthesis window and overlap-added; every output sample is divided by the sum of
+// squared windows that covered it, so analysis followed by synthesis reproduces the signal
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <fft_stft.hpp>
+
+// Block-streaming inverse STFT: push frames as they come, finished samples are written to a caller buffer.
+// All accumulation happens in buffers allocated by the constructor.
+class InverseStft {
+public:
+    // same win_len / hop_len / n_fft / center / window as the analysis; throws std::invalid_argument
+    InverseStft(int win_len, int hop_len, int n_fft = 0, bool center = false,
+                const WindowSpec& window = WindowSpec());
+    InverseStft(const InverseStft&) = delete;
+    InverseStft& operator=(const InverseStft&) = delete;
+
+    int fftSize() const { return ifft_.size(); }
+    int bins() const { return ifft_.bins(); }
+    int hopLen() const { return hop_len_; }
+    int64_t framesProcessed() const { return frames_; }
+
+    // frames holds n_frames rows of bins() values; each frame finishes hop_len samples
+    // (minus the leading n_fft / 2 when centered). out needs room for n_frames * hop_len, returns samples written
+    size_t process(const std::complex<double>* frames, int n_frames, double* out);
+
+    // end of stream: write the tail still in the accumulator (at most n_fft samples), then reset()
+    // centered, the last n_fft / 2 samples belong to the padding and are dropped unless trim_padding is false
+    // (keep them when the true signal length is known and may run into them)
+    size_t flush(double* out, bool trim_padding = true);
+    void reset();
+
+private:
+    void addFrame(const std::complex<double>* spectrum);
+    size_t emit(size_t count, double* out);
+
+    int hop_len_;
+    bool center_;
+    std::shared_ptr<const WindowTable> window_;
+    int offset_;                 // (n_fft - win_len) / 2, where the window sits in the frame
+    InverseFftPlan ifft_;
+    std::vector<double> acc_;    // overlap-add sum, acc_[0] is the first unfinished sample
+    std::vector<double> norm_;   // sum of squared synthesis windows for the same samples
+    size_t skip_;                // centered: leading samples still to drop
+    int64_t frames_;
+};
+
+// Batch inverse STFT of [n_frames][n_fft / 2 + 1] frames; length >= 0 trims or zero-pads the result
+std::vector<double> compute_istft(
+    const std::vector<std::vector<std::complex<double>>>& stft,
+    int win_len,
+    int hop_len,
+    int n_fft = 0,
+    bool center = false,
+    const WindowSpec& window = WindowSpec(),
+    long length = -1);
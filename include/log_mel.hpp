@@ -0,0 +1,33 @@
+// Log mel spectrogram cpp header
+// the stage of compute_mfcc before the DCT, for feature dumps: log(mel energy + 1e-10) per band, optionally
+// normalized per band to zero mean and unit variance over the frames, stored straight as float32, float16 or
+// bfloat16. The log, the normalization and the narrowing run per frame through a small float tile (a float
+// polynomial log and bit-exact round-to-nearest-even conversions, plain loops the compiler vectorizes), so no
+// double log-mel array is ever materialized.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <fft_stft.hpp>
+
+// float16 is IEEE half, bfloat16 the upper 16 bits of a float32; both are stored as their uint16 bit patterns
+enum class LogMelDtype { Float32, Float16, BFloat16 };
+
+LogMelDtype parse_log_mel_dtype(const std::string& name);  // "float32", "float16" or "bfloat16"
+const char* log_mel_dtype_name(LogMelDtype dtype);
+size_t log_mel_dtype_size(LogMelDtype dtype);  // bytes per value
+
+// scalar conversions, round to nearest even (overflow goes to inf, NaN stays NaN)
+uint16_t float_to_half(float value);
+float half_to_float(uint16_t bits);
+uint16_t float_to_bfloat16(float value);
+float bfloat16_to_float(uint16_t bits);
+
+// Log mel energies of n_frames spectrum rows (fft_size / 2 + 1 bins, 2x when complex, like compute_mfcc):
+// out holds n_frames rows of n_mel values of dtype. normalize subtracts each band's mean over these frames
+// and divides by its standard deviation (this reads the spectrogram twice instead of keeping a copy).
+// The log is computed in float, so float32 results match compute_mfcc's log mel energies to about 1e-7
+// relative. Kernels are kept per thread, repeated calls allocate nothing.
+void compute_log_mel(const double* spectrogram, int n_frames, int sample_rate, int fft_size, int n_mel,
+                     SpectrumType spectrum, LogMelDtype dtype, bool normalize, void* out);
@@ -1,21 +1,99 @@
 #pragma once
 #include <vector>
+#include <string>
 #include <mutex>
 #include <atomic>
+#include <memory>
+#include <thread>
+#include <cstdint>
 #include <portaudio.h>
+#include <stream_features.hpp>
+
+// Reference-counted PortAudio runtime: Pa_Initialize on first acquire, Pa_Terminate when the last holder goes
+// every stream (capture sessions, players) holds one instead of calling Pa_Initialize/Pa_Terminate itself
+class PortAudioRuntime {
+public:
+    static std::shared_ptr<PortAudioRuntime> acquire();  // throws std::runtime_error if PortAudio fails to start
+    ~PortAudioRuntime();
+
+private:
+    PortAudioRuntime() = default;
+};
+
+// Sample formats we can open the input stream with (converted to mono float in the callback)
+enum class SampleFormat { Int16, Int24, Float32 };
+
+SampleFormat parse_sample_format(const std::string& name);  // "int16", "int24" or "float32"
+const char* sample_format_name(SampleFormat format);
+
+// Requested stream parameters, negotiated against the device with Pa_IsFormatSupported in start()
+struct CaptureConfig {
+    int device_index = -1;        // -1 = use device_name, or the default input device if that is empty
+    std::string device_name;      // case-insensitive substring of the device name
+    int channels = 1;
+    SampleFormat sample_format = SampleFormat::Float32;
+    double latency = 0.0;         // suggested latency in seconds, 0 = device default low input latency
+};
+
+struct InputDeviceInfo {
+    int index;
+    std::string name;
+    std::string host_api;
+    int max_input_channels;
+    double default_sample_rate;
+    double default_low_latency;
+    double default_high_latency;
+    bool is_default;
+};
+
+std::vector<InputDeviceInfo> list_input_devices();
+
+// Virtual input: a WAV file played through the same callback path as a live device
+struct FileSourceConfig {
+    bool realtime = true;           // pace buffers at the file's sample rate, false = as fast as possible
+                                    // without dropping: waits for the feature engine and get_feature_frames
+    double jitter_ms = 0.0;         // each buffer is delivered up to this much late (uniform random)
+    double xrun_probability = 0.0;  // chance a buffer is dropped and the next one flagged paInputOverflow
+    unsigned seed = 0;              // jitter/xrun random seed, runs are reproducible
+    bool loop = false;              // restart at end of file instead of stopping
+};
+
+struct StreamStats {
+    uint64_t callbacks = 0;
+    uint64_t frames = 0;            // frames delivered to processInput
+    uint64_t xruns = 0;             // overflow flags seen by the callback (real or injected)
+    uint64_t dropped_samples = 0;   // feature engine ring buffer overruns
+    uint64_t dropped_frames = 0;    // feature frames overwritten before Python drained them
+};
 
 class AudioStreamer {
 public:
-    AudioStreamer(int sample_rate = 48000, int frames_per_buffer = 512);
+    AudioStreamer(int sample_rate = 48000, int frames_per_buffer = 512,
+                  const CaptureConfig& config = CaptureConfig());
     ~AudioStreamer();
 
     bool start();
+    bool startFile(const std::string& path, const FileSourceConfig& source = FileSourceConfig());
     void stop();
     bool isRunning() const; 
     void flushBuffer();
 
     std::vector<float> getBufferedAudio();  // pull a chunk
 
+    // what start() actually opened (valid while running)
+    int deviceIndex() const { return device_; }
+    int channels() const { return channels_; }
+    SampleFormat sampleFormat() const { return format_; }
+    double inputLatency() const { return input_latency_; }
+    int sampleRate() const { return sample_rate_; }
+    StreamStats stats() const;
+
+    // streaming feature engine, runs on its own worker thread while the stream is running
+    void enableFeatures(const FeatureEngineConfig& config = FeatureEngineConfig());
+    void disableFeatures();
+    bool featuresEnabled() const;
+    std::vector<FeatureFrame> getFeatureFrames();  // drain frames published since the last call
+
 private:
     static int streamCallback(const void* inputBuffer, void* outputBuffer,
                               unsigned long framesPerBuffer,
@@ -23,12 +101,34 @@ private:
                               PaStreamCallbackFlags statusFlags,
                               void* userData);
 
-    void processInput(const float* input, size_t frameCount);
+    PaDeviceIndex resolveDevice() const;
+    bool negotiate(PaDeviceIndex dev, const PaDeviceInfo* devInfo, PaStreamParameters& params) const;
+    void processInput(const void* input, size_t frameCount);
+    void setStreamRate(int rate);
+    void runFileSource(void* file, FileSourceConfig source);
 
     PaStream* stream_;
-    std::vector<float> buffer_;
+    std::vector<float> buffer_;  // ring of the last second of mono audio (sample_rate_ samples) for Python
+    size_t buffer_head_;
+    size_t buffer_size_;
     std::mutex buffer_mutex_;
     std::atomic<bool> running_;
-    int sample_rate_;
+    int sample_rate_;       // of the current (or last) session, a file source runs at the file's rate
+    int configured_rate_;   // what live start() opens the device at
     int frames_per_buffer_;
+
+    CaptureConfig config_;
+    PaDeviceIndex device_;
+    int channels_;
+    SampleFormat format_;
+    double input_latency_;
+
+    std::shared_ptr<PortAudioRuntime> portaudio_;  // acquired on the first live start()
+    std::thread source_thread_;    // file source, replaces the PortAudio stream when used
+    std::atomic<uint64_t> callbacks_;
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> xruns_;
+
+    std::vector<float> mono_;  // callback scratch, sized for frames_per_buffer_
+    std::unique_ptr<StreamFeatureEngine> engine_;
 };
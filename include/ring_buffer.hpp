@@ -0,0 +1,66 @@
+// Single-producer / single-consumer lock-free ring buffer
+// producer is the PortAudio callback, consumer is a worker thread (no locks, no allocation after construction)
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+
+template <typename T>
+class RingBuffer {
+public:
+    // capacity is rounded up to a power of two so indices can be masked instead of wrapped
+    explicit RingBuffer(size_t capacity = 0) { reset(capacity); }
+
+    // not thread safe, only call while neither side is running
+    void reset(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        data_.assign(cap, T());
+        mask_ = cap - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return data_.size(); }
+
+    // number of items ready to read
+    size_t available() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    // producer side: write up to count items, returns number written (rest is dropped when full)
+    size_t push(const T* src, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t space = data_.size() - (head - tail);
+        size_t n = std::min(count, space);
+        for (size_t i = 0; i < n; ++i)
+            data_[(head + i) & mask_] = src[i];
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // consumer side: read up to count items, returns number read
+    size_t pop(T* dst, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t n = std::min(count, head - tail);
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = data_[(tail + i) & mask_];
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // consumer side: drop everything currently buffered
+    void clear() {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    std::vector<T> data_;
+    size_t mask_ = 0;
+    std::atomic<size_t> head_{0};  // total items written
+    std::atomic<size_t> tail_{0};  // total items read
+};
@@ -0,0 +1,18 @@
+// Runtime SIMD capability report cpp header
+// which instruction sets the CPU has, which FFTW codelet sets were built in, and which ones the
+// planner actually picks for our transforms (FFTW selects codelets by cpuid when a plan is made)
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct SimdReport {
+    std::string fftw_version;
+    std::vector<std::string> cpu;       // sse2, avx, avx2, fma, avx512f as supported by the CPU and OS
+    std::vector<std::string> built;     // codelet sets compiled into FFTW, empty when not known (system FFTW)
+    std::vector<std::string> active;    // codelet sets used by the probe plans; empty = scalar codelets only
+    std::string plan;                   // fftw_sprint_plan of the probe r2c plan
+};
+
+// plans an r2c and a c2r transform of n_fft (FFTW_ESTIMATE, like FftPlan) and reads their codelet names
+SimdReport simd_report(int n_fft = 1024);
@@ -0,0 +1,105 @@
+// Real-time streaming feature engine cpp header
+// a worker thread consumes the capture ring buffer and computes features once per hop
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <ring_buffer.hpp>
+#include <fft_stft.hpp>
+
+struct FeatureEngineConfig {
+    int win_len = 1024;
+    int hop_len = 512;
+    int n_mel = 26;
+    int n_mfcc = 13;
+    WindowSpec window;          // symmetric Hann by default
+    size_t queue_frames = 256;  // frames kept for Python before the oldest are dropped
+};
+
+// One analysis frame, timestamped in stream time (seconds since start of capture)
+struct FeatureFrame {
+    int64_t index = 0;
+    double timestamp = 0.0;   // start of the frame in stream time
+    double latency = 0.0;     // seconds between the newest samples arriving and the frame being published
+    float rms = 0.0f;
+    float zcr = 0.0f;
+    double centroid = 0.0;
+    std::vector<double> mfcc;
+};
+
+class StreamFeatureEngine {
+public:
+    StreamFeatureEngine(int sample_rate, const FeatureEngineConfig& config = FeatureEngineConfig());
+    ~StreamFeatureEngine();
+
+    void start();
+    void stop();  // frames for samples already pushed are still computed before the worker exits
+    bool isRunning() const;
+
+    // producer side, called from the audio callback (lock-free, no allocation)
+    void push(const float* mono, size_t count);
+
+    // lossless mode, for sources faster than real time (file playback): the worker waits for drain() instead
+    // of overwriting frames, and the producer waits for ring space with waitForSpace() before push().
+    // Only change while stopped
+    void setLossless(bool lossless) { lossless_ = lossless; }
+    // producer side: wait up to timeout for room for count samples / until every complete hop pushed so far
+    // is published; false on timeout, so the caller can check its own stop flag and wait again
+    bool waitForSpace(size_t count, std::chrono::milliseconds timeout);
+    bool waitUntilProcessed(std::chrono::milliseconds timeout);
+
+    // consumer side, returns and removes all published frames
+    std::vector<FeatureFrame> drain();
+
+    // discard buffered samples and frames, restart frame numbering
+    void reset();
+
+    const FeatureEngineConfig& config() const { return config_; }
+    uint64_t droppedSamples() const { return dropped_samples_; }
+    uint64_t droppedFrames() const { return dropped_frames_; }
+
+private:
+    void run();
+    void processAvailable();
+    void processFrame();
+    void publish();
+
+    int sample_rate_;
+    FeatureEngineConfig config_;
+
+    RingBuffer<float> input_;
+    std::atomic<int64_t> last_push_ns_;
+    std::atomic<uint64_t> dropped_samples_;
+    std::atomic<uint64_t> pushed_;   // samples that made it into the ring since construction / reset()
+    std::atomic<bool> lossless_;
+
+    std::thread worker_;
+    std::atomic<bool> running_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+
+    // analysis state, only touched by the worker thread
+    std::unique_ptr<SpectrumProcessor> spectrum_;
+    std::unique_ptr<MfccProcessor> mfcc_;
+    std::vector<float> frame_;       // last win_len samples
+    std::vector<double> magnitude_;
+    size_t frame_fill_;              // samples in frame_ before the first full window
+    int64_t next_index_;
+    FeatureFrame current_;
+
+    // published frames, preallocated slots reused round robin
+    std::mutex queue_mutex_;
+    std::condition_variable slot_free_;  // drain() -> worker waiting in publish() (lossless)
+    std::condition_variable progress_;   // worker -> producer waiting for space or for its frames
+    std::vector<FeatureFrame> slots_;
+    size_t queue_head_;
+    size_t queue_size_;
+    int64_t published_;                  // frames published since construction / reset()
+    std::atomic<uint64_t> dropped_frames_;
+};
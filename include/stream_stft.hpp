@@ -0,0 +1,83 @@
+// Incremental STFT cpp header, the analysis counterpart of InverseStft (istft.hpp)
+// samples arrive in blocks of any size (capture callbacks, get_live_audio_buffer chunks); the frames that
+// straddle block boundaries are completed from a carry of the last n_fft - hop_len samples, frames inside a
+// block are read from it in place. All blocks plus flush() give exactly compute_stft's frames for the
+// concatenated signal, bit for bit, numbered by their absolute index in the stream.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <fft_stft.hpp>
+
+class StreamingStft {
+public:
+    // receives each completed frame as its fftSize() samples before windowing, valid during the call only
+    class FrameSink {
+    public:
+        virtual void frame(const float* samples) = 0;
+        virtual void frame(const double* samples) = 0;
+
+    protected:
+        ~FrameSink() {}
+    };
+
+    // same parameters as compute_stft; throws std::invalid_argument
+    StreamingStft(int win_len, int hop_len, int n_fft = 0, bool center = false,
+                  PadMode pad_mode = PadMode::Constant, const WindowSpec& window = WindowSpec(),
+                  SpectrumType spectrum = SpectrumType::Magnitude);
+    StreamingStft(const StreamingStft&) = delete;
+    StreamingStft& operator=(const StreamingStft&) = delete;
+
+    int fftSize() const { return spectrum_.fftSize(); }
+    int bins() const { return spectrum_.bins(); }
+    int hopLen() const { return hop_len_; }
+    int rowSize() const { return spectrum_values(type_, bins()); }  // values per frame in out
+    SpectrumType spectrum() const { return type_; }
+
+    // frames the next push() of n samples completes, and what flush() would emit now
+    int numFrames(size_t n) const;
+    int flushFrames() const;
+
+    // next block of the stream: out gets numFrames(n) rows of rowSize() values, returns the rows written.
+    // They are frames [framesEmitted() before the call, framesEmitted() after it)
+    int push(const float* samples, size_t n, double* out);
+    int push(const double* samples, size_t n, double* out);
+    // end of stream: the frames that reach into the right padding when centered (none otherwise), then reset()
+    int flush(double* out);
+    // the same frames handed to sink unwindowed, for callers with their own per-frame features (Extractor);
+    // frames inside a block point into it, the others are assembled from the carry as doubles
+    int push(const float* samples, size_t n, FrameSink& sink);
+    int push(const double* samples, size_t n, FrameSink& sink);
+    int flush(FrameSink& sink);
+    void reset();  // forget carried samples, the next push starts a new stream at frame 0
+
+    int64_t framesEmitted() const { return frames_; }
+    int64_t samplesPushed() const { return samples_; }
+
+private:
+    template <typename T> int pushSamples(const T* samples, size_t n, FrameSink& sink);
+    template <typename T> int feed(const T* samples, size_t n, FrameSink& sink);
+    void remember(const double* samples, size_t n);
+    int padLeft(FrameSink& sink);
+    int framesAfter(size_t n) const;
+
+    int hop_len_;
+    bool center_;
+    PadMode pad_mode_;
+    SpectrumType type_;
+    SpectrumProcessor spectrum_;
+    int pad_;                    // n_fft / 2 when centered, else 0
+    std::vector<double> carry_;  // samples from the next frame start on, fewer than n_fft
+    size_t fill_;
+    size_t skip_;                // hop_len > n_fft: samples still to drop before the next frame starts
+    std::vector<double> frame_;  // a frame assembled from carry_ and the new block
+    // centered: the first pad_ + 1 samples (the left padding mirrors them) and the latest pad_ + 1 (the right
+    // padding at flush); the left padding goes in as soon as the head is complete
+    std::vector<double> head_;
+    std::vector<double> tail_;
+    std::vector<double> padding_;
+    bool padded_left_;
+    int64_t frames_;
+    int64_t samples_;
+};
@@ -0,0 +1,13 @@
+// Time-domain audio features cpp header (RMS and ZCR)
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Root Mean Square
+float calc_rms(const float* sig, size_t N);
+float calc_rms(const std::vector<float>& sig);
+
+// Zero Crossing Rate
+float calc_zcr(const float* sig, size_t N);
+float calc_zcr(const std::vector<float>& sig);
@@ -0,0 +1,53 @@
+// Scoped trace spans with Chrome / Perfetto trace export
+// AF_TRACE_SCOPE("fft") records the enclosing scope's start and duration into a per-thread buffer
+// (the owning thread is the only writer, so recording takes no lock). trace::dump(path) writes every thread's
+// events as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Spans compile away unless AUDIO_FEATURES_TRACE is defined (CMake option of the same name), and record
+// nothing until trace::enable(true) is called.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace trace {
+
+extern std::atomic<bool> g_enabled;
+
+void enable(bool on);
+bool enabled();
+bool compiled_in();                      // false when spans were compiled out
+void clear();                            // drop recorded events and finished threads' buffers, call while
+                                         // no traced work is running
+bool dump(const std::string& path);      // write Chrome trace JSON, false if the file can't be written
+uint64_t dropped();                      // events lost because a thread buffer was full
+
+int64_t now_ns();
+void record(const char* name, int64_t start_ns, int64_t end_ns);
+
+// name must be a string literal (only the pointer is stored)
+class Span {
+public:
+    explicit Span(const char* name)
+        : name_(g_enabled.load(std::memory_order_relaxed) ? name : nullptr), start_(name_ ? now_ns() : 0) {}
+    ~Span() {
+        if (name_) record(name_, start_, now_ns());
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name_;
+    int64_t start_;
+};
+
+} // namespace trace
+
+#define AF_TRACE_CONCAT_(a, b) a##b
+#define AF_TRACE_CONCAT(a, b) AF_TRACE_CONCAT_(a, b)
+
+#ifdef AUDIO_FEATURES_TRACE
+#define AF_TRACE_SCOPE(name) ::trace::Span AF_TRACE_CONCAT(af_trace_span_, __LINE__)(name)
+#else
+#define AF_TRACE_SCOPE(name) ((void)0)
+#endif
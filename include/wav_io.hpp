@@ -0,0 +1,23 @@
+// WAV / libsndfile reading cpp header
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+
+// get wave data from selected file: interleaved samples in [-1.0, 1.0] and the sample rate
+// (empty vector if the file can't be opened)
+std::pair<std::vector<float>, int> get_wav_data(std::string const wav_filename);
+
+// header only, no samples decoded
+struct WavFileInfo {
+    int64_t frames = 0;
+    int sample_rate = 0;
+    int channels = 0;
+};
+
+bool get_wav_info(const std::string& wav_filename, WavFileInfo& info);
+
+// channels averaged to mono, and the sample rate; throws std::runtime_error if the file can't be opened
+std::pair<std::vector<float>, int> get_wav_mono(const std::string& wav_filename);
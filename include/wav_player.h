@@ -1,6 +1,75 @@
 #pragma once // Ensure this header file only included once by compiler
 
 #include <string> // For using std::string to handle file paths
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <portaudio.h>
+#include "ring_buffer.hpp"
 
-// Declares a function that will play a WAV file at the given file path
-void play_wav_file(const std::string& filepath);
\ No newline at end of file
+class PortAudioRuntime;
+
+// Declares a function that will play a WAV file at the given file path (blocks until playback ends)
+void play_wav_file(const std::string& filepath);
+
+// In-process WAV player: a decoder thread reads the file with libsndfile into a lock-free ring buffer,
+// the PortAudio output callback drains it. play/pause/stop/seek return immediately.
+class WavPlayer {
+public:
+    explicit WavPlayer(const std::string& filepath);  // throws std::runtime_error if the file or device fails
+    ~WavPlayer();
+
+    WavPlayer(const WavPlayer&) = delete;
+    WavPlayer& operator=(const WavPlayer&) = delete;
+
+    void play();                   // start or resume from the current position
+    void pause();                  // keep position, output silence
+    void stop();                   // pause and rewind to the start
+    void seek(double seconds);     // jump to a position, playback state is unchanged
+    void close();                  // stop the stream and decoder thread (also done by the destructor)
+
+    bool isPlaying() const;        // false when paused, stopped or at end of file
+    double position() const;       // seconds of audio sent to the device
+    double duration() const;
+    int sampleRate() const { return sample_rate_; }
+    int channels() const { return channels_; }
+
+private:
+    static int streamCallback(const void* inputBuffer, void* outputBuffer,
+                              unsigned long framesPerBuffer,
+                              const PaStreamCallbackTimeInfo* timeInfo,
+                              PaStreamCallbackFlags statusFlags,
+                              void* userData);
+
+    void decodeLoop();
+    void renderOutput(float* out, unsigned long frames);
+
+    std::shared_ptr<PortAudioRuntime> portaudio_;
+    void* file_;                   // SNDFILE*, kept out of the header
+    PaStream* stream_;
+    int sample_rate_;
+    int channels_;
+    int64_t total_frames_;
+
+    RingBuffer<float> ring_;       // interleaved samples, decoder -> callback
+    std::thread decoder_;
+    std::mutex decoder_mutex_;
+    std::condition_variable decoder_wake_;
+    std::atomic<bool> closing_;
+    std::atomic<uint64_t> eof_gen_;  // seek generation at which the decoder hit end of file
+
+    std::atomic<bool> playing_;
+    std::atomic<bool> stream_started_;
+    std::atomic<int64_t> played_frames_;
+
+    // seek handshake: seek() bumps seek_gen_, the decoder stops pushing and asks the callback to flush
+    // (flush_gen_), the callback clears the ring and acks (flushed_gen_), then the decoder seeks the file
+    std::atomic<uint64_t> seek_gen_;
+    std::atomic<int64_t> seek_target_;
+    std::atomic<uint64_t> flush_gen_;
+    std::atomic<uint64_t> flushed_gen_;
+};
@@ -0,0 +1,46 @@
+// Window functions cpp header
+// tables are computed once per (type, length, periodic, beta) and shared through a process-wide cache,
+// the batch STFT, the Extractor and the streaming engine all window through it
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class WindowType { Rectangular, Hann, Hamming, Blackman, BlackmanHarris, Kaiser, FlatTop };
+
+// "rectangular", "hann", "hamming", "blackman", "blackmanharris", "kaiser" or "flattop"
+// throws std::invalid_argument on anything else
+WindowType parse_window_type(const std::string& name);
+const char* window_type_name(WindowType type);
+
+struct WindowSpec {
+    WindowType type = WindowType::Hann;
+    bool periodic = false;  // periodic (DFT-even, for spectral analysis) or symmetric (filter design)
+    double beta = 8.6;      // Kaiser shape parameter, ignored by the other types
+};
+
+WindowSpec make_window_spec(const std::string& name, bool periodic = false, double beta = 8.6);
+
+// Immutable window samples in SIMD-aligned storage
+class WindowTable {
+public:
+    WindowTable(const WindowSpec& spec, int length);
+    ~WindowTable();
+    WindowTable(const WindowTable&) = delete;
+    WindowTable& operator=(const WindowTable&) = delete;
+
+    int size() const { return length_; }
+    const double* data() const { return data_; }
+    const double& operator[](int i) const { return data_[i]; }
+
+private:
+    int length_;
+    double* data_;
+};
+
+// cached table for spec and length (thread safe, computed on first use)
+std::shared_ptr<const WindowTable> get_window(const WindowSpec& spec, int length);
+
+// plain copy of the window samples
+std::vector<double> window_samples(const WindowSpec& spec, int length);
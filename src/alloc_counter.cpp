@@ -0,0 +1,104 @@
+// Counting replacements for the global operator new/delete family, see alloc_counter.hpp
+// thread-local counters are plain integers (no atomics on the owning thread); global totals use relaxed atomics.
+
+#include <alloc_counter.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local AllocStats t_stats;
+std::atomic<uint64_t> g_allocs(0);
+std::atomic<uint64_t> g_frees(0);
+std::atomic<uint64_t> g_bytes(0);
+
+void count_alloc(std::size_t size) {
+    ++t_stats.allocs;
+    t_stats.bytes += size;
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void count_free() {
+    ++t_stats.frees;
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* counted_alloc(std::size_t size) {
+    count_alloc(size);
+    for (;;) {
+        if (void* p = std::malloc(size ? size : 1)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void counted_free(void* p) {
+    if (!p) return;
+    count_free();
+    std::free(p);
+}
+
+} // namespace
+
+AllocStats alloc_stats_thread() {
+    return t_stats;
+}
+
+AllocStats alloc_stats_global() {
+    AllocStats s;
+    s.allocs = g_allocs.load(std::memory_order_relaxed);
+    s.frees = g_frees.load(std::memory_order_relaxed);
+    s.bytes = g_bytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+void* operator new(std::size_t size) {
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_alloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_alloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    counted_free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    counted_free(p);
+}
@@ -28,166 +28,315 @@ g++ -Iinclude -Isrc \
 
 #include <pybind11/pybind11.h> // must install Python development packaget and add its include path when compiling (sudo apt install python3-dev)
 #include <pybind11/stl.h>   // automatic conversion of std::vector
+#include <pybind11/complex.h>
 #include <pybind11/numpy.h> // for upgrade to numpy support (no longer need vector or pybind11/stl.h unless I use std::vector elsewhere)
                             // change all std::vector<float> to py::array_t<float>, use sig.request() and buf.ptr if I want to switch
                             // py::array_t<T> is how pybind11 maps NumPy arrays to C++
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <sndfile.h>
 #include <iostream>
 #include <sndfile.h>
 #include <fftw3.h>
 #include <complex>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <fft_stft.hpp>
-#include <portaudio_capture.hpp>
+#include <log_mel.hpp>
+#include <time_features.hpp>
+#include <wav_io.hpp>
+#include <trace.hpp>
+#include <simd_report.hpp>
 
-//port audio capture
-std::unique_ptr<AudioStreamer> g_streamer;
+namespace py = pybind11;
 
-void start_streaming(int sample_rate = 48000, int frames_per_buffer = 512) {
-    std::cout << "start_streaming start" << "\n";
-    if (!g_streamer) {
-        g_streamer = std::make_unique<AudioStreamer>(sample_rate, frames_per_buffer);
-        g_streamer->start();
-    }
-    std::cout << "start_streaming end" << "\n";
-}
+// live capture sessions and streaming features (audio_streamer_pybind.cpp)
+void bind_audio_streamer(py::module_& m);
+// stateful Extractor (extractor_pybind.cpp)
+void bind_extractor(py::module_& m);
+// complex STFT, streaming STFT and inverse STFT (istft_pybind.cpp)
+void bind_istft(py::module_& m);
+// many files on a work-stealing pool (batch_extract_pybind.cpp)
+void bind_batch_extract(py::module_& m);
+// one long file through a decode/compute/write pipeline (file_pipeline_pybind.cpp)
+void bind_file_pipeline(py::module_& m);
+// columnar feature files (feature_file_pybind.cpp)
+void bind_feature_file(py::module_& m);
+// on-disk feature cache (feature_cache_pybind.cpp)
+void bind_feature_cache(py::module_& m);
 
-void stop_streaming() {
-    std::cout << "stop_streaming start" << "\n";
-    if (g_streamer) {
-        g_streamer->stop();
-        //g_streamer.reset();
-    }
-    std::cout << "stop_streaming end" << "\n";
+namespace {
 
+// argument/result conversion happens in these helpers rather than in pybind's casters
+// so it shows up as its own span next to the compute in dump_trace()
+template <typename T>
+T from_python(const py::handle& obj) {
+    AF_TRACE_SCOPE("convert_in");
+    return obj.cast<T>();
 }
 
-void clear_buffer() {
-    if (g_streamer) {
-        g_streamer->flushBuffer();
-        g_streamer.reset();
-    }
+template <typename T>
+py::object to_python(T&& value) {
+    AF_TRACE_SCOPE("convert_out");
+    return py::cast(std::forward<T>(value));
 }
 
-std::vector<float> get_live_audio_buffer() {
-    std::cout << "get_live_audio_buffer start" << "\n";
-    if (g_streamer) {
-        std::cout << "g_streamer found" << "\n";
-        return g_streamer->getBufferedAudio();
-    }
-    std::cout << "get_live_audio_buffer end" << "\n";
-
-    return {};
-}
+using Spectrogram = std::vector<std::vector<double>>;
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
 
-// get wave data from selected file and 
-std::pair<std::vector<float>, int> get_wav_data(std::string const wav_filename) {
-    // convert string soundfile name to char
-    const char* wav_filename_char = wav_filename.c_str();
-    
-    std::vector<float> signal_vector;
-    SF_INFO sfinfo;
-    SNDFILE *file = sf_open(wav_filename_char, SFM_READ, &sfinfo);
-    int sample_rate = sfinfo.samplerate;
-
-    if (!file) {
-        std::cerr << "Failed to open file\n";
-        return std::make_pair(signal_vector, sample_rate);
+// out= arrays are filled in place, so they must already be what the call would return
+py::array checked_out(const py::object& out, const std::vector<py::ssize_t>& shape, bool dtype_ok,
+                      const char* dtype) {
+    if (!dtype_ok) throw py::value_error(std::string("out must be a C-contiguous ") + dtype + " array");
+    py::array a = py::reinterpret_borrow<py::array>(out);
+    if (!a.writeable()) throw py::value_error("out must be writeable");
+    bool same = a.ndim() == static_cast<py::ssize_t>(shape.size());
+    for (size_t i = 0; same && i < shape.size(); ++i) same = a.shape(i) == shape[i];
+    if (!same) {
+        std::string expected = "(";
+        for (size_t i = 0; i < shape.size(); ++i) expected += (i ? ", " : "") + std::to_string(shape[i]);
+        throw py::value_error("out must have shape " + expected + (shape.size() == 1 ? ",)" : ")"));
     }
+    return a;
+}
 
-    std::vector<short> samples(sfinfo.frames * sfinfo.channels);
-    sf_readf_short(file, samples.data(), sfinfo.frames);
-    sf_close(file);
-
-    // DEBUGGING
-    // // Print size of vector
-    // std::cout << "Vector Size before cast: " << samples.size() << std::endl;
-
-    // // Print first 10 samples of std::vector<short>
-    // for (int i = 0; i < 10 && i < samples.size(); ++i) {
-    //     std::cout << "Short Sample[" << i << "] = " << samples[i] << "\n";
-    // }
+template <typename T>
+py::array checked_out(const py::object& out, const std::vector<py::ssize_t>& shape, const char* dtype) {
+    return checked_out(out, shape, py::isinstance<py::array_t<T, py::array::c_style>>(out), dtype);
+}
 
-    // Convert short samples to float in range [-1.0, 1.0]
-    signal_vector.reserve(samples.size());
-    for (short s : samples) {
-        signal_vector.push_back(static_cast<float>(s) / 32768.0f);
+// float16 has no C++ type to check against
+py::array checked_half_out(const py::object& out, const std::vector<py::ssize_t>& shape) {
+    bool ok = py::isinstance<py::array>(out);
+    if (ok) {
+        py::array a = py::reinterpret_borrow<py::array>(out);
+        ok = a.dtype().kind() == 'f' && a.dtype().itemsize() == 2 && (a.flags() & py::array::c_style);
     }
-
-    // DEBUGGING    
-    // // Print first 10 samples of std::vector<float>
-    // for (int i = 0; i < 10 && i < samples.size(); ++i) {
-    //     std::cout << "Float Sample[" << i << "] = " << samples[i] << "\n";
-    // }
-
-    // // Print size of vector
-    // std::cout << "Vector Size just before return: " << samples.size() << std::endl;
-
-    return std::make_pair(signal_vector, sample_rate);
+    return checked_out(out, shape, ok, "float16");
 }
 
+// spectrogram argument of the out= paths: a 2-D array, converted only when it isn't C-contiguous float64
+DoubleArray spectrogram_array(const py::object& spectrogram) {
+    DoubleArray a = DoubleArray::ensure(spectrogram);
+    if (!a || a.ndim() != 2) throw py::value_error("with out=, spectrogram must be a 2-D array");
+    return a;
+}
 
-// audio feature functions (currently rms and zcr)
-float calc_rms(const std::vector<float>& sig) {
-    float squares = 0.0;
-    int N = sig.size();
-
-    for (int i = 0; i < N; ++i) {
-        squares += (sig[i] * sig[i]);
+py::object stft_into(const py::object& signal, int win_len, int hop_len, int n_fft, bool center, PadMode mode,
+                     const WindowSpec& spec, SpectrumType type, Layout layout, const py::object& out) {
+    py::array samples = py::array::ensure(signal);
+    if (!samples || samples.ndim() != 1) throw py::value_error("with out=, signal must be a 1-D array");
+    const size_t n = static_cast<size_t>(samples.shape(0));
+    const py::ssize_t frames = stft_num_frames(n, win_len, hop_len, n_fft, center);
+    const py::ssize_t bins = (n_fft > 0 ? n_fft : win_len) / 2 + 1;
+    const std::vector<py::ssize_t> shape = layout == Layout::TimeMajor ? std::vector<py::ssize_t>{frames, bins}
+                                                                       : std::vector<py::ssize_t>{bins, frames};
+    py::array dst = type == SpectrumType::Complex ? checked_out<std::complex<double>>(out, shape, "complex128")
+                                                  : checked_out<double>(out, shape, "float64");
+    double* p = static_cast<double*>(dst.mutable_data());
+    if (py::isinstance<py::array_t<float, py::array::c_style>>(samples)) {
+        // float32 frames are windowed straight from the caller's array
+        py::array_t<float> f = py::reinterpret_borrow<py::array_t<float>>(samples);
+        py::gil_scoped_release release;
+        compute_stft(f.data(), n, win_len, hop_len, n_fft, center, mode, spec, type, p, layout);
+    } else {
+        DoubleArray d = DoubleArray::ensure(samples);
+        py::gil_scoped_release release;
+        compute_stft(d.data(), n, win_len, hop_len, n_fft, center, mode, spec, type, p, layout);
     }
-    // Print statement for debugging
-    // std::cout << sqrt(squares/ static_cast<float>(N)) << std::endl;
-
-    return std::sqrt(squares / static_cast<float>(N));
+    return out;
 }
 
-float calc_zcr(const std::vector<float>& sig) {
-    int zcr_count = 0;
-    int same_sign_count = 1;
-    int N = sig.size(); //total number of samples in the audio sig
+} // namespace
+
+// python module definition
+PYBIND11_MODULE(audio_features, m) {
+    m.doc() = "Audio feature extraction module (zcr and rms numpy version)";
+    m.def("get_wav_data", [](const std::string& path) {
+        return to_python(get_wav_data(path));
+    }, "Read a Wav file and return samples as a float vector and sample rate as an int");
+    m.def("calc_rms", [](py::object signal) {
+        return calc_rms(from_python<std::vector<float>>(signal));
+    }, "Calculate Root Mean Square of a 1D NumPy array");
+    m.def("calc_zcr", [](py::object signal) {
+        return calc_zcr(from_python<std::vector<float>>(signal));
+    }, "Calculate Zero Crossing Rate of a 1D NumPy array");
+    m.def("compute_stft", [](py::object signal, int win_len, int hop_len, int n_fft, bool center,
+                             const std::string& pad_mode, const std::string& window, bool periodic, double kaiser_beta,
+                             const std::string& output, const std::string& layout_name,
+                             py::object out) -> py::object {
+        PadMode mode = parse_pad_mode(pad_mode);
+        WindowSpec spec = make_window_spec(window, periodic, kaiser_beta);
+        SpectrumType type = parse_spectrum_type(output);
+        Layout layout = parse_layout(layout_name);
+        if (!out.is_none()) return stft_into(signal, win_len, hop_len, n_fft, center, mode, spec, type, layout, out);
+        Spectrogram stft = compute_stft(from_python<std::vector<double>>(signal), win_len, hop_len, n_fft, center, mode,
+                                        spec, type, layout);
+        if (type != SpectrumType::Complex) return to_python(std::move(stft));
 
-    for (int i = 1; i < N; ++i) { // start comparison at second sig to compare to first
-        int current_sign = (sig[i] > 0) - (sig[i] < 0);
-        int prev_sign = (sig[i - same_sign_count] > 0) - (sig[i - same_sign_count] < 0);
+        // complex rows are interleaved re/im, they go out as one complex128 array (in either layout)
+        AF_TRACE_SCOPE("convert_out");
+        py::ssize_t cols = stft.empty() ? 0 : static_cast<py::ssize_t>(stft[0].size() / 2);
+        py::array_t<std::complex<double>> result({static_cast<py::ssize_t>(stft.size()), cols});
+        double* dst = reinterpret_cast<double*>(result.mutable_data());
+        for (size_t r = 0; r < stft.size(); ++r)
+            std::copy(stft[r].begin(), stft[r].end(), dst + r * 2 * cols);
+        return std::move(result);
+    }, py::arg("signal"), py::arg("win_len"), py::arg("hop_len"), py::arg("n_fft") = 0, py::arg("center") = false,
+       py::arg("pad_mode") = "constant", py::arg("window") = "hann", py::arg("periodic") = false,
+       py::arg("kaiser_beta") = 8.6, py::arg("output") = "magnitude", py::arg("layout") = "time",
+       py::arg("out") = py::none(),
+       "Compute STFT; n_fft >= win_len zero-pads frames (0 = win_len), "
+       "center pads n_fft // 2 samples each side with pad_mode 'constant', 'reflect' or 'edge'. "
+       "output: 'magnitude' (default), 'power', 'log_power' (dB) or 'complex' (complex128 array). "
+       "layout: 'time' gives [n_frames][bins], 'frequency' gives [bins][n_frames] without a separate transpose. "
+       "out: a preallocated C-contiguous float64 (complex128) array of that shape to fill and return "
+       "instead of a new list; signal must then be a 1-D array (float32 is used as is)");
+    m.def("get_window", [](const std::string& window, int length, bool periodic, double kaiser_beta) {
+        return window_samples(make_window_spec(window, periodic, kaiser_beta), length);
+    }, py::arg("window"), py::arg("length"), py::arg("periodic") = false, py::arg("kaiser_beta") = 8.6,
+       "Window samples from the shared table cache (hann, hamming, blackman, blackmanharris, kaiser, flattop, "
+       "rectangular)");
+    m.def("compute_spectral_centroid", [](py::object spectrogram, int sample_rate, int fft_size,
+                                          py::object out) -> py::object {
+        if (out.is_none())
+            return to_python(compute_spectral_centroid(from_python<Spectrogram>(spectrogram), sample_rate, fft_size));
+        DoubleArray spec = spectrogram_array(spectrogram);
+        py::array dst = checked_out<double>(out, {spec.shape(0)}, "float64");
+        {
+            py::gil_scoped_release release;
+            compute_spectral_centroid(spec.data(), static_cast<int>(spec.shape(0)), static_cast<int>(spec.shape(1)),
+                                      sample_rate, fft_size, static_cast<double*>(dst.mutable_data()));
+        }
+        return out;
+    }, py::arg("spectrogram"), py::arg("sample_rate"), py::arg("fft_size"), py::arg("out") = py::none(),
+       "Compute spectral centroid from STFT (out: preallocated float64 array of n_frames values)");
+    m.def("compute_spectral_rolloff", [](py::object spectrogram, int sample_rate, int fft_size, double rolloff_pct,
+                                         py::object out) -> py::object {
+        if (out.is_none())
+            return to_python(compute_spectral_rolloff(from_python<Spectrogram>(spectrogram), sample_rate, fft_size,
+                                                      rolloff_pct));
+        DoubleArray spec = spectrogram_array(spectrogram);
+        py::array dst = checked_out<double>(out, {spec.shape(0)}, "float64");
+        {
+            py::gil_scoped_release release;
+            compute_spectral_rolloff(spec.data(), static_cast<int>(spec.shape(0)), static_cast<int>(spec.shape(1)),
+                                     sample_rate, fft_size, rolloff_pct, static_cast<double*>(dst.mutable_data()));
+        }
+        return out;
+    }, py::arg("spectrogram"), py::arg("sample_rate"), py::arg("fft_size"), py::arg("rolloff_pct") = 0.99,
+       py::arg("out") = py::none(),
+       "Compute spectral rolloff frequency (Hz) for each frame (out: preallocated float64 array of n_frames values)");
+    m.def("compute_mfcc", [](py::object spectrogram, int sample_rate, int fft_size, int n_mel, int n_mfcc,
+                             const std::string& spectrum, const std::string& layout_name,
+                             py::object out) -> py::object {
+        SpectrumType type = parse_spectrum_type(spectrum);
+        Layout layout = parse_layout(layout_name);
+        const bool time_major = layout == Layout::TimeMajor;
+        const py::ssize_t bins = fft_size / 2 + 1;
+        if (out.is_none()) {
+            Spectrogram rows = from_python<Spectrogram>(spectrogram);
+            if (!time_major && !rows.empty() && static_cast<py::ssize_t>(rows.size()) != bins)
+                throw py::value_error("a frequency-major spectrogram needs fft_size // 2 + 1 rows");
+            return to_python(compute_mfcc(rows, sample_rate, fft_size, n_mel, n_mfcc, type, layout));
+        }
+        if (type == SpectrumType::Complex) throw py::value_error("with out=, spectrogram rows must be real");
+        if (n_mel <= 0 || n_mfcc <= 0 || n_mfcc > n_mel) throw py::value_error("n_mfcc must be in (0, n_mel]");
+        DoubleArray spec = spectrogram_array(spectrogram);
+        if (spec.shape(time_major ? 1 : 0) != bins)
+            throw py::value_error(std::string("spectrogram must have fft_size // 2 + 1 = ") + std::to_string(bins) +
+                                  (time_major ? " columns" : " rows"));
+        const py::ssize_t frames = spec.shape(time_major ? 0 : 1);
+        py::array dst = checked_out<double>(out, time_major ? std::vector<py::ssize_t>{frames, n_mfcc}
+                                                            : std::vector<py::ssize_t>{n_mfcc, frames}, "float64");
+        {
+            py::gil_scoped_release release;
+            compute_mfcc(spec.data(), static_cast<int>(frames), sample_rate, fft_size, n_mel, n_mfcc, type,
+                         static_cast<double*>(dst.mutable_data()), layout);
+        }
+        return out;
+    }, py::arg("spectrogram"), py::arg("sample_rate"), py::arg("fft_size"), py::arg("n_mel"), py::arg("n_mfcc"),
+       py::arg("spectrum") = "magnitude", py::arg("layout") = "time", py::arg("out") = py::none(),
+       "Compute MFCCs given spectrogram; returns [n_frames][n_mfcc]. spectrum says what the rows hold "
+       "('magnitude', 'power' or 'log_power' as returned by compute_stft). "
+       "layout 'frequency': the spectrogram is [bins][n_frames] (compute_stft(layout='frequency')) and the "
+       "result [n_mfcc][n_frames]. out: preallocated float64 array of the result's shape to fill and return; "
+       "spectrogram must then be a 2-D array");
 
-        if (current_sign == 0 || current_sign == prev_sign) {
-            same_sign_count++;
+    m.def("compute_log_mel", [](py::object spectrogram, int sample_rate, int fft_size, int n_mel,
+                                const std::string& spectrum, const std::string& dtype_name, bool normalize,
+                                py::object out) -> py::object {
+        SpectrumType type = parse_spectrum_type(spectrum);
+        LogMelDtype dtype = parse_log_mel_dtype(dtype_name);
+        if (sample_rate <= 0 || fft_size <= 0 || n_mel <= 0)
+            throw py::value_error("sample_rate, fft_size and n_mel must be positive");
+        // complex rows are read as interleaved re/im doubles
+        using ComplexArray = py::array_t<std::complex<double>, py::array::c_style | py::array::forcecast>;
+        py::array spec = type == SpectrumType::Complex ? py::array(ComplexArray::ensure(spectrogram))
+                                                       : py::array(DoubleArray::ensure(spectrogram));
+        if (!spec || spec.ndim() != 2) throw py::value_error("spectrogram must be a 2-D array (or list of rows)");
+        const py::ssize_t bins = fft_size / 2 + 1;
+        if (spec.shape(1) != bins)
+            throw py::value_error("spectrogram rows must have fft_size // 2 + 1 = " + std::to_string(bins) + " bins");
+        const py::ssize_t frames = spec.shape(0);
+        // float16 is a NumPy dtype, bfloat16 is not: its bit patterns come back as uint16
+        // (arr.view(ml_dtypes.bfloat16), or torch.from_numpy(arr).view(torch.bfloat16))
+        const std::vector<py::ssize_t> shape = {frames, n_mel};
+        py::array dst;
+        if (dtype == LogMelDtype::Float32) {
+            dst = out.is_none() ? py::array_t<float>(shape) : checked_out<float>(out, shape, "float32");
+        } else if (dtype == LogMelDtype::Float16) {
+            dst = out.is_none() ? py::array(py::dtype::from_args(py::str("float16")), shape)
+                                : checked_half_out(out, shape);
         } else {
-            zcr_count++;
-            same_sign_count = 1;
+            dst = out.is_none() ? py::array_t<uint16_t>(shape) : checked_out<uint16_t>(out, shape, "uint16");
         }
-    }
-    // Print statement for debugging
-    // std::cout << static_cast<float>(zcr_count) / N << std::endl;
+        {
+            py::gil_scoped_release release;
+            compute_log_mel(static_cast<const double*>(spec.data()), static_cast<int>(frames), sample_rate, fft_size,
+                            n_mel, type, dtype, normalize, dst.mutable_data());
+        }
+        return out.is_none() ? py::object(dst) : out;
+    }, py::arg("spectrogram"), py::arg("sample_rate"), py::arg("fft_size"), py::arg("n_mel") = 26,
+       py::arg("spectrum") = "magnitude", py::arg("dtype") = "float32", py::arg("normalize") = false,
+       py::arg("out") = py::none(),
+       "Log mel spectrogram (the stage of compute_mfcc before the DCT) as an (n_frames, n_mel) array. "
+       "spectrum says what the rows hold, as in compute_mfcc ('complex' takes the complex128 array of "
+       "compute_stft(output='complex')). dtype: 'float32' (default), 'float16', or 'bfloat16' (returned as the "
+       "uint16 bit patterns). normalize: per-band zero mean / unit variance over the frames. "
+       "out: preallocated C-contiguous array of that shape and dtype to fill and return");
 
-    return static_cast<float>(zcr_count) / N;
-}
+    m.def("simd_report", [](int n_fft) {
+        SimdReport report = simd_report(n_fft);
+        py::dict d;
+        d["fftw_version"] = report.fftw_version;
+        d["cpu"] = report.cpu;
+        d["built"] = report.built;
+        d["active"] = report.active;
+        d["plan"] = report.plan;
+        return d;
+    }, py::arg("n_fft") = 1024,
+       "SIMD capability report: CPU instruction sets, FFTW codelet sets built in, and the ones the planner "
+       "uses for an n_fft transform ('active' empty = scalar FFT)");
 
-// python module definition
-PYBIND11_MODULE(audio_features, m) {
-    m.doc() = "Audio feature extraction module (zcr and rms numpy version)";
-    m.def("get_wav_data", &get_wav_data, "Read a Wav file and return samples as a float vector and sample rate as an int");
-    m.def("calc_rms", &calc_rms, "Calculate Root Mean Square of a 1D NumPy array");
-    m.def("calc_zcr", &calc_zcr, "Calculate Zero Crossing Rate of a 1D NumPy array");
-    m.def("compute_stft", &compute_stft, "Compute STFT (amplitude spectrum)");
-    m.def("compute_spectral_centroid", &compute_spectral_centroid, "Compute spectral centroid from STFT");
-    m.def("compute_spectral_rolloff", &compute_spectral_rolloff, "Compute spectral rolloff frequency (Hz) for each frame");
-    m.def("compute_mfcc", &compute_mfcc, "Compute MFCCs given spectrogram; returns [n_frames][n_mfcc]");
-    m.def("start_streaming", &start_streaming, "Start live audio capture");
-    m.def("stop_streaming", &stop_streaming, "Stop live audio capture");
-    m.def("get_live_audio_buffer", &get_live_audio_buffer, "Get current live audio buffer");
-    m.def("start_streaming", [](int sample_rate, int hop_size) {
-        g_streamer = std::make_unique<AudioStreamer>(sample_rate, hop_size);
-        if (!g_streamer->start()) throw std::runtime_error("Failed to start stream");
-    });
-    m.def("stop_streaming", []() {
-        g_streamer->stop();
-    });
-    m.def("get_live_audio_buffer", []() {
-        return g_streamer->getBufferedAudio();
-    });
-    m.def("flush_buffer", []() {
-        g_streamer->flushBuffer();
-    });
+    // tracing (spans are compiled in with -DAUDIO_FEATURES_TRACE=ON, the default)
+    m.def("enable_trace", &trace::enable, py::arg("on") = true,
+          "Start (or stop) recording trace spans from every thread");
+    m.def("clear_trace", &trace::clear, "Drop recorded trace events");
+    m.def("dump_trace", [](const std::string& path) {
+        if (!trace::compiled_in())
+            std::cerr << "dump_trace: module built without AUDIO_FEATURES_TRACE, the trace will be empty\n";
+        if (!trace::dump(path)) throw std::runtime_error("Cannot write trace file " + path);
+        return trace::dropped();
+    }, py::arg("path"), "Write recorded spans as Chrome/Perfetto trace JSON, returns the number of dropped events");
+
+    bind_extractor(m);
+    bind_istft(m);
+    bind_batch_extract(m);
+    bind_file_pipeline(m);
+    bind_feature_file(m);
+    bind_feature_cache(m);
+    bind_audio_streamer(m);
 }
@@ -0,0 +1,199 @@
+// Python bindings for live capture sessions (AudioStreamer) and the streaming feature engine
+// every AudioStreamer instance is an independent session with its own ring buffer and feature pipeline,
+// the module-level start_streaming/stop_streaming/... functions drive one default session for old scripts
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <portaudio_capture.hpp>
+#include <stream_features.hpp>
+
+namespace py = pybind11;
+
+namespace {
+
+// device: None for the default input, an int index, or a (case-insensitive) substring of the device name
+CaptureConfig make_capture_config(const py::object& device, int channels, const std::string& sample_format,
+                                  double latency) {
+    CaptureConfig config;
+    if (py::isinstance<py::int_>(device)) config.device_index = device.cast<int>();
+    else if (py::isinstance<py::str>(device)) config.device_name = device.cast<std::string>();
+    else if (!device.is_none()) throw py::type_error("device must be None, an int index or a name");
+    config.channels = channels;
+    config.sample_format = parse_sample_format(sample_format);
+    config.latency = latency;
+    return config;
+}
+
+FeatureEngineConfig make_feature_config(int win_len, int hop_len, int n_mel, int n_mfcc, size_t queue_frames,
+                                        const std::string& window, bool periodic) {
+    FeatureEngineConfig config;
+    config.window = make_window_spec(window, periodic);
+    config.win_len = win_len;
+    config.hop_len = hop_len;
+    config.n_mel = n_mel;
+    config.n_mfcc = n_mfcc;
+    config.queue_frames = queue_frames;
+    return config;
+}
+
+FileSourceConfig make_file_source(bool realtime, double jitter_ms, double xrun_probability, unsigned seed, bool loop) {
+    FileSourceConfig source;
+    source.realtime = realtime;
+    source.jitter_ms = jitter_ms;
+    source.xrun_probability = xrun_probability;
+    source.seed = seed;
+    source.loop = loop;
+    return source;
+}
+
+py::dict stats_dict(const AudioStreamer& streamer) {
+    StreamStats s = streamer.stats();
+    py::dict d;
+    d["sample_rate"] = streamer.sampleRate();
+    d["callbacks"] = s.callbacks;
+    d["frames"] = s.frames;
+    d["xruns"] = s.xruns;
+    d["dropped_samples"] = s.dropped_samples;
+    d["dropped_frames"] = s.dropped_frames;
+    return d;
+}
+
+// default session behind the module-level functions
+std::unique_ptr<AudioStreamer> g_streamer;
+std::unique_ptr<FeatureEngineConfig> g_feature_config;  // applied when the default session is created
+
+} // namespace
+
+void bind_audio_streamer(py::module_& m) {
+    py::class_<InputDeviceInfo>(m, "InputDeviceInfo")
+        .def_readonly("index", &InputDeviceInfo::index)
+        .def_readonly("name", &InputDeviceInfo::name)
+        .def_readonly("host_api", &InputDeviceInfo::host_api)
+        .def_readonly("max_input_channels", &InputDeviceInfo::max_input_channels)
+        .def_readonly("default_sample_rate", &InputDeviceInfo::default_sample_rate)
+        .def_readonly("default_low_latency", &InputDeviceInfo::default_low_latency)
+        .def_readonly("default_high_latency", &InputDeviceInfo::default_high_latency)
+        .def_readonly("is_default", &InputDeviceInfo::is_default);
+    m.def("list_input_devices", &list_input_devices, "List PortAudio devices with input channels");
+
+    py::class_<FeatureFrame>(m, "FeatureFrame")
+        .def_readonly("index", &FeatureFrame::index)
+        .def_readonly("timestamp", &FeatureFrame::timestamp)
+        .def_readonly("latency", &FeatureFrame::latency)
+        .def_readonly("rms", &FeatureFrame::rms)
+        .def_readonly("zcr", &FeatureFrame::zcr)
+        .def_readonly("centroid", &FeatureFrame::centroid)
+        .def_readonly("mfcc", &FeatureFrame::mfcc);
+
+    // ------------------------------------------------------------------ capture sessions
+    py::class_<AudioStreamer>(m, "AudioStreamer")
+        .def(py::init([](int sample_rate, int frames_per_buffer, py::object device, int channels,
+                         const std::string& sample_format, double latency) {
+                 return std::make_unique<AudioStreamer>(sample_rate, frames_per_buffer,
+                     make_capture_config(device, channels, sample_format, latency));
+             }),
+             py::arg("sample_rate") = 48000, py::arg("frames_per_buffer") = 512, py::arg("device") = py::none(),
+             py::arg("channels") = 1, py::arg("sample_format") = "float32", py::arg("latency") = 0.0)
+        .def("start", [](AudioStreamer& self) {
+                 if (!self.start()) throw std::runtime_error("Failed to start stream");
+             }, "Open and start the input device")
+        .def("start_file", [](AudioStreamer& self, const std::string& path, bool realtime, double jitter_ms,
+                              double xrun_probability, unsigned seed, bool loop) {
+                 if (!self.startFile(path, make_file_source(realtime, jitter_ms, xrun_probability, seed, loop)))
+                     throw std::runtime_error("Failed to start file source");
+             },
+             py::arg("path"), py::arg("realtime") = true, py::arg("jitter_ms") = 0.0,
+             py::arg("xrun_probability") = 0.0, py::arg("seed") = 0, py::arg("loop") = false,
+             "Stream a WAV file through the capture path as a virtual input device; realtime=False runs as fast "
+             "as the features are computed and drained, dropping nothing")
+        .def("stop", &AudioStreamer::stop, py::call_guard<py::gil_scoped_release>(),
+             "Stop capture (joins the source and feature threads)")
+        .def("is_running", &AudioStreamer::isRunning)
+        .def("enable_features", [](AudioStreamer& self, int win_len, int hop_len, int n_mel, int n_mfcc,
+                                   size_t queue_frames, const std::string& window, bool periodic) {
+                 self.enableFeatures(make_feature_config(win_len, hop_len, n_mel, n_mfcc, queue_frames, window,
+                                                         periodic));
+             },
+             py::arg("win_len") = 1024, py::arg("hop_len") = 512, py::arg("n_mel") = 26,
+             py::arg("n_mfcc") = 13, py::arg("queue_frames") = 256, py::arg("window") = "hann",
+             py::arg("periodic") = false,
+             "Compute features per hop on a worker thread (call while stopped)")
+        .def("disable_features", &AudioStreamer::disableFeatures)
+        .def("get_feature_frames", &AudioStreamer::getFeatureFrames, "Drain feature frames published since the last call")
+        .def("get_buffered_audio", &AudioStreamer::getBufferedAudio, "Get (and clear) the last second of mono audio")
+        .def("flush_buffer", &AudioStreamer::flushBuffer)
+        .def("stats", &stats_dict, "Callback, frame, xrun and drop counters")
+        .def_property_readonly("sample_rate", &AudioStreamer::sampleRate)
+        .def_property_readonly("device_index", &AudioStreamer::deviceIndex)
+        .def_property_readonly("channels", &AudioStreamer::channels)
+        .def_property_readonly("sample_format", [](const AudioStreamer& self) {
+            return std::string(sample_format_name(self.sampleFormat()));
+        })
+        .def_property_readonly("input_latency", &AudioStreamer::inputLatency);
+
+    // ------------------------------------------------------------------ default session
+    m.def("start_streaming", [](int sample_rate, int frames_per_buffer, py::object device, int channels,
+                                const std::string& sample_format, double latency) {
+              if (g_streamer && g_streamer->isRunning()) return;
+              g_streamer = std::make_unique<AudioStreamer>(sample_rate, frames_per_buffer,
+                  make_capture_config(device, channels, sample_format, latency));
+              if (g_feature_config) g_streamer->enableFeatures(*g_feature_config);
+              if (!g_streamer->start()) {
+                  g_streamer.reset();
+                  throw std::runtime_error("Failed to start stream");
+              }
+          },
+          py::arg("sample_rate") = 48000, py::arg("frames_per_buffer") = 512, py::arg("device") = py::none(),
+          py::arg("channels") = 1, py::arg("sample_format") = "float32", py::arg("latency") = 0.0,
+          "Start live audio capture on the default session");
+    m.def("start_streaming_file", [](const std::string& path, int frames_per_buffer, bool realtime, double jitter_ms,
+                                     double xrun_probability, unsigned seed, bool loop) {
+              if (g_streamer && g_streamer->isRunning())
+                  throw std::runtime_error("Streaming already running, call stop_streaming first");
+              g_streamer = std::make_unique<AudioStreamer>(48000, frames_per_buffer);
+              if (g_feature_config) g_streamer->enableFeatures(*g_feature_config);
+              if (!g_streamer->startFile(path, make_file_source(realtime, jitter_ms, xrun_probability, seed, loop))) {
+                  g_streamer.reset();
+                  throw std::runtime_error("Failed to start file source");
+              }
+          },
+          py::arg("path"), py::arg("frames_per_buffer") = 512, py::arg("realtime") = true,
+          py::arg("jitter_ms") = 0.0, py::arg("xrun_probability") = 0.0, py::arg("seed") = 0,
+          py::arg("loop") = false,
+          "Stream a WAV file through the capture path of the default session");
+    m.def("stop_streaming", []() {
+              if (g_streamer) {
+                  py::gil_scoped_release release;
+                  g_streamer->stop();
+              }
+          }, "Stop the default session");
+    m.def("is_streaming", []() { return g_streamer && g_streamer->isRunning(); },
+          "True while the default session is running (False once a file source reaches EOF)");
+    m.def("get_stream_stats", []() { return g_streamer ? stats_dict(*g_streamer) : py::dict(); },
+          "Callback, frame, xrun and drop counters for the default session");
+    m.def("get_live_audio_buffer", []() {
+              return g_streamer ? g_streamer->getBufferedAudio() : std::vector<float>();
+          }, "Get current live audio buffer of the default session");
+    m.def("flush_buffer", []() { if (g_streamer) g_streamer->flushBuffer(); },
+          "Clear the live audio buffer of the default session");
+    m.def("enable_stream_features", [](int win_len, int hop_len, int n_mel, int n_mfcc, size_t queue_frames,
+                                       const std::string& window, bool periodic) {
+              FeatureEngineConfig config = make_feature_config(win_len, hop_len, n_mel, n_mfcc, queue_frames, window,
+                                                               periodic);
+              g_feature_config = std::make_unique<FeatureEngineConfig>(config);
+              if (g_streamer && !g_streamer->isRunning()) g_streamer->enableFeatures(config);
+          },
+          py::arg("win_len") = 1024, py::arg("hop_len") = 512, py::arg("n_mel") = 26,
+          py::arg("n_mfcc") = 13, py::arg("queue_frames") = 256, py::arg("window") = "hann",
+          py::arg("periodic") = false,
+          "Compute features per hop on a worker thread while streaming (call before start_streaming)");
+    m.def("get_feature_frames", []() {
+              return g_streamer ? g_streamer->getFeatureFrames() : std::vector<FeatureFrame>();
+          }, "Drain feature frames published since the last call");
+
+    // stop the default session before the interpreter tears down
+    m.add_object("_cleanup_default_session", py::capsule([]() { g_streamer.reset(); }));
+}
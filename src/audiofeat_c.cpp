@@ -0,0 +1,253 @@
+// C API over the feature core, see audiofeat.h
+// every entry point catches C++ exceptions and turns them into a status plus a per-thread message
+
+#include <audiofeat.h>
+#include <extractor.hpp>
+#include <time_features.hpp>
+#include <wav_io.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+struct audiofeat_extractor {
+    explicit audiofeat_extractor(const ExtractorConfig& config) : extractor(config) {}
+    Extractor extractor;
+    FeatureSet out;  // storage behind the last audiofeat_result
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+audiofeat_status fail(audiofeat_status status, const char* message) {
+    last_error = message;
+    return status;
+}
+
+// runs fn, mapping exceptions to status codes
+template <typename Fn>
+audiofeat_status guarded(Fn fn) {
+    try {
+        fn();
+        return AUDIOFEAT_OK;
+    } catch (const std::invalid_argument& e) {
+        return fail(AUDIOFEAT_ERR_ARGUMENT, e.what());
+    } catch (const std::bad_alloc&) {
+        return fail(AUDIOFEAT_ERR_MEMORY, "out of memory");
+    } catch (const std::exception& e) {
+        return fail(AUDIOFEAT_ERR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(AUDIOFEAT_ERR_INTERNAL, "unknown error");
+    }
+}
+
+// the C enums have fixed values, map them explicitly instead of casting onto the C++ enums
+PadMode to_pad_mode(int mode) {
+    switch (mode) {
+        case AUDIOFEAT_PAD_CONSTANT: return PadMode::Constant;
+        case AUDIOFEAT_PAD_REFLECT: return PadMode::Reflect;
+        case AUDIOFEAT_PAD_EDGE: return PadMode::Edge;
+    }
+    throw std::invalid_argument("Unknown pad mode");
+}
+
+WindowType to_window_type(int window) {
+    switch (window) {
+        case AUDIOFEAT_WINDOW_RECTANGULAR: return WindowType::Rectangular;
+        case AUDIOFEAT_WINDOW_HANN: return WindowType::Hann;
+        case AUDIOFEAT_WINDOW_HAMMING: return WindowType::Hamming;
+        case AUDIOFEAT_WINDOW_BLACKMAN: return WindowType::Blackman;
+        case AUDIOFEAT_WINDOW_BLACKMAN_HARRIS: return WindowType::BlackmanHarris;
+        case AUDIOFEAT_WINDOW_KAISER: return WindowType::Kaiser;
+        case AUDIOFEAT_WINDOW_FLATTOP: return WindowType::FlatTop;
+    }
+    throw std::invalid_argument("Unknown window type");
+}
+
+SpectrumType to_spectrum_type(int spectrum) {
+    switch (spectrum) {
+        case AUDIOFEAT_SPECTRUM_COMPLEX: return SpectrumType::Complex;
+        case AUDIOFEAT_SPECTRUM_MAGNITUDE: return SpectrumType::Magnitude;
+        case AUDIOFEAT_SPECTRUM_POWER: return SpectrumType::Power;
+        case AUDIOFEAT_SPECTRUM_LOG_POWER: return SpectrumType::LogPower;
+    }
+    throw std::invalid_argument("Unknown spectrum type");
+}
+
+// c.field when the caller's struct (struct_size bytes, older headers have fewer fields) holds it, else the
+// audiofeat_config_init default; the field is never read past the end of the caller's struct
+#define AUDIOFEAT_FIELD(c, field, defaults) \
+    (offsetof(audiofeat_config, field) + sizeof((c).field) <= (c).struct_size ? (c).field : (defaults).field)
+
+ExtractorConfig to_config(const audiofeat_config& c) {
+    if (c.struct_size == 0)
+        throw std::invalid_argument("audiofeat_config not initialized with audiofeat_config_init");
+    audiofeat_config defaults;
+    audiofeat_config_init(&defaults);
+    ExtractorConfig config;
+    config.sample_rate = AUDIOFEAT_FIELD(c, sample_rate, defaults);
+    config.n_fft = AUDIOFEAT_FIELD(c, n_fft, defaults);
+    config.win_len = AUDIOFEAT_FIELD(c, win_len, defaults);
+    config.hop_len = AUDIOFEAT_FIELD(c, hop_len, defaults);
+    config.center = AUDIOFEAT_FIELD(c, center, defaults) != 0;
+    config.pad_mode = to_pad_mode(AUDIOFEAT_FIELD(c, pad_mode, defaults));
+    config.window.type = to_window_type(AUDIOFEAT_FIELD(c, window, defaults));
+    config.window.periodic = AUDIOFEAT_FIELD(c, periodic, defaults) != 0;
+    config.window.beta = AUDIOFEAT_FIELD(c, kaiser_beta, defaults);
+    config.spectrum = to_spectrum_type(AUDIOFEAT_FIELD(c, spectrum, defaults));
+    config.n_mel = AUDIOFEAT_FIELD(c, n_mel, defaults);
+    config.n_mfcc = AUDIOFEAT_FIELD(c, n_mfcc, defaults);
+    config.rolloff_pct = AUDIOFEAT_FIELD(c, rolloff_pct, defaults);
+    config.features = AUDIOFEAT_FIELD(c, features, defaults);
+    return config;
+}
+
+#undef AUDIOFEAT_FIELD
+
+template <typename T>
+const T* or_null(const std::vector<T>& v) {
+    return v.empty() ? nullptr : v.data();
+}
+
+void to_result(const FeatureSet& out, audiofeat_result* result) {
+    result->n_frames = out.n_frames;
+    result->n_bins = out.n_bins;
+    result->n_mfcc = out.n_mfcc;
+    result->spectrum = or_null(out.spectrum);
+    result->centroid = or_null(out.centroid);
+    result->rolloff = or_null(out.rolloff);
+    result->mfcc = or_null(out.mfcc);
+    result->rms = or_null(out.rms);
+    result->zcr = or_null(out.zcr);
+}
+
+} // namespace
+
+extern "C" {
+
+int audiofeat_abi_version(void) {
+    return AUDIOFEAT_ABI_VERSION;
+}
+
+const char* audiofeat_last_error(void) {
+    return last_error.c_str();
+}
+
+void audiofeat_free(void* p) {
+    std::free(p);
+}
+
+audiofeat_status audiofeat_read_wav(const char* path, float** samples, size_t* n_samples, int* sample_rate,
+                                    int* channels) {
+    if (!path || !samples || !n_samples) return fail(AUDIOFEAT_ERR_ARGUMENT, "path, samples and n_samples required");
+    *samples = nullptr;
+    *n_samples = 0;
+    audiofeat_status status = guarded([&] {
+        WavFileInfo info;
+        if (!get_wav_info(path, info)) throw std::runtime_error(std::string("Cannot open ") + path);
+        std::pair<std::vector<float>, int> wav = get_wav_data(path);
+
+        float* copy = static_cast<float*>(std::malloc(wav.first.size() * sizeof(float) + 1));
+        if (!copy) throw std::bad_alloc();
+        std::memcpy(copy, wav.first.data(), wav.first.size() * sizeof(float));
+        *samples = copy;
+        *n_samples = wav.first.size();
+        if (sample_rate) *sample_rate = wav.second;
+        if (channels) *channels = info.channels;
+    });
+    // anything but bad arguments or memory here is the file's fault
+    return status == AUDIOFEAT_ERR_INTERNAL ? AUDIOFEAT_ERR_IO : status;
+}
+
+float audiofeat_rms(const float* signal, size_t n) {
+    return signal && n ? calc_rms(signal, n) : 0.0f;
+}
+
+float audiofeat_zcr(const float* signal, size_t n) {
+    return signal && n ? calc_zcr(signal, n) : 0.0f;
+}
+
+void audiofeat_config_init(audiofeat_config* config) {
+    if (!config) return;
+    ExtractorConfig defaults;
+    std::memset(config, 0, sizeof(*config));
+    config->struct_size = sizeof(audiofeat_config);
+    config->sample_rate = defaults.sample_rate;
+    config->n_fft = defaults.n_fft;
+    config->win_len = defaults.win_len;
+    config->hop_len = defaults.hop_len;
+    config->center = defaults.center;
+    config->pad_mode = AUDIOFEAT_PAD_CONSTANT;
+    config->window = AUDIOFEAT_WINDOW_HANN;
+    config->periodic = defaults.window.periodic;
+    config->kaiser_beta = defaults.window.beta;
+    config->spectrum = AUDIOFEAT_SPECTRUM_MAGNITUDE;
+    config->n_mel = defaults.n_mel;
+    config->n_mfcc = defaults.n_mfcc;
+    config->rolloff_pct = defaults.rolloff_pct;
+    config->features = defaults.features;
+}
+
+audiofeat_status audiofeat_extractor_create(const audiofeat_config* config, audiofeat_extractor** extractor) {
+    if (!config || !extractor) return fail(AUDIOFEAT_ERR_ARGUMENT, "config and extractor required");
+    *extractor = nullptr;
+    return guarded([&] { *extractor = new audiofeat_extractor(to_config(*config)); });
+}
+
+void audiofeat_extractor_destroy(audiofeat_extractor* extractor) {
+    delete extractor;
+}
+
+int audiofeat_extractor_num_bins(const audiofeat_extractor* extractor) {
+    return extractor ? extractor->extractor.numBins() : 0;
+}
+
+int audiofeat_extractor_num_frames(const audiofeat_extractor* extractor, size_t n_samples) {
+    return extractor ? extractor->extractor.numFrames(n_samples) : 0;
+}
+
+audiofeat_status audiofeat_extractor_process(audiofeat_extractor* extractor, const float* signal, size_t n,
+                                             audiofeat_result* result) {
+    if (!extractor || !result || (!signal && n)) return fail(AUDIOFEAT_ERR_ARGUMENT, "null argument");
+    return guarded([&] {
+        extractor->extractor.process(signal, n, extractor->out);
+        to_result(extractor->out, result);
+    });
+}
+
+audiofeat_status audiofeat_extractor_process_batch(audiofeat_extractor* extractor, const float* clips,
+                                                   size_t n_clips, size_t stride, const size_t* lengths,
+                                                   int* frames_per_clip, audiofeat_result* result) {
+    if (!extractor || !result || !frames_per_clip || (!clips && n_clips && stride))
+        return fail(AUDIOFEAT_ERR_ARGUMENT, "null argument");
+    return guarded([&] {
+        *frames_per_clip = extractor->extractor.processBatch(clips, n_clips, stride, lengths, extractor->out);
+        to_result(extractor->out, result);
+    });
+}
+
+audiofeat_status audiofeat_extractor_process_block(audiofeat_extractor* extractor, const float* block, size_t n,
+                                                   audiofeat_result* result) {
+    if (!extractor || !result || (!block && n)) return fail(AUDIOFEAT_ERR_ARGUMENT, "null argument");
+    return guarded([&] {
+        extractor->extractor.processBlock(block, n, extractor->out);
+        to_result(extractor->out, result);
+    });
+}
+
+audiofeat_status audiofeat_extractor_flush(audiofeat_extractor* extractor, audiofeat_result* result) {
+    if (!extractor || !result) return fail(AUDIOFEAT_ERR_ARGUMENT, "null argument");
+    return guarded([&] {
+        extractor->extractor.flush(extractor->out);
+        to_result(extractor->out, result);
+    });
+}
+
+void audiofeat_extractor_reset(audiofeat_extractor* extractor) {
+    if (extractor) extractor->extractor.reset();
+}
+
+} // extern "C"
@@ -0,0 +1,60 @@
+/**
+ * Plain C consumer of the audiofeat_core library (no Python, no C++ types)
+ * replaces the old valgrind_test_audio_features.cpp, which carried its own copies of get_wav_data/calc_rms:
+ * this links the same code the Python module runs, so it is also the valgrind target
+ *
+ * BUILD (CMake target)
+ *   cmake --build build --target audiofeat_example
+ *
+ * RUN
+ *   ./build/audiofeat_example data/file_example_WAV_1MG.wav
+ *
+ * VALGRIND
+ *   valgrind --leak-check=full --track-origins=yes --time-stamp=yes -s ./build/audiofeat_example data/file_example_WAV_1MG.wav
+ */
+
+#include <stdio.h>
+#include <audiofeat.h>
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "data/file_example_WAV_1MG.wav";
+    float* signal = NULL;
+    size_t n = 0;
+    int sample_rate = 0;
+    int channels = 0;
+
+    if (audiofeat_read_wav(path, &signal, &n, &sample_rate, &channels) != AUDIOFEAT_OK) {
+        fprintf(stderr, "%s\n", audiofeat_last_error());
+        return 1;
+    }
+    printf("Sample rate: %d, channels: %d, samples: %zu\n", sample_rate, channels, n);
+    printf("RMS: %f\n", audiofeat_rms(signal, n));
+    printf("ZCR: %f\n", audiofeat_zcr(signal, n));
+
+    audiofeat_config config;
+    audiofeat_config_init(&config);
+    config.sample_rate = sample_rate;
+    config.n_fft = 512;
+    config.hop_len = 256;
+
+    audiofeat_extractor* extractor = NULL;
+    if (audiofeat_extractor_create(&config, &extractor) != AUDIOFEAT_OK) {
+        fprintf(stderr, "%s\n", audiofeat_last_error());
+        audiofeat_free(signal);
+        return 1;
+    }
+
+    audiofeat_result result;
+    int status = audiofeat_extractor_process(extractor, signal, n, &result);
+    if (status == AUDIOFEAT_OK && result.n_frames > 0) {
+        printf("STFT frames: %d (%d bins)\n", result.n_frames, result.n_bins);
+        printf("frame 0: centroid %.1f Hz, rolloff %.1f Hz, mfcc[0] %.3f\n",
+               result.centroid[0], result.rolloff[0], result.mfcc[0]);
+    } else if (status != AUDIOFEAT_OK) {
+        fprintf(stderr, "%s\n", audiofeat_last_error());
+    }
+
+    audiofeat_extractor_destroy(extractor);
+    audiofeat_free(signal);
+    return status == AUDIOFEAT_OK ? 0 : 1;
+}
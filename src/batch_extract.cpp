@@ -0,0 +1,332 @@
+// Batch feature extraction over many files, see batch_extract.hpp
+// a task is either "decode file i" or "frames [first, first + count) of file i"; decoding a file pushes its
+// chunks onto the decoding worker's own deque, idle workers steal them from the other end
+
+#include <batch_extract.hpp>
+#include <wav_io.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+struct FileJob {
+    FileFeatures result;
+    std::vector<float> mono;       // decoded samples, freed once the last chunk is done
+    std::atomic<int> chunks_left;
+    std::atomic<bool> failed;      // a chunk threw, the remaining ones are skipped
+    uint64_t cache_key = 0;
+    bool cached = false;           // features came from the cache, nothing to store
+};
+
+struct Task {
+    FileJob* job;
+    int first;
+    int count;  // < 0: decode the file
+};
+
+// owner works at the back, thieves take from the front, so a worker keeps the chunks it just made hot in
+// cache while the oldest (largest remaining) work moves away
+struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+class BatchRun {
+public:
+    BatchRun(const std::vector<std::string>& paths, const ExtractorConfig& config, const BatchOptions& options,
+             const FileCallback& on_file)
+        : config_(config), on_file_(on_file), cache_(options.cache), chunk_frames_(std::max(1, options.chunk_frames)),
+          pending_(paths.size()), stop_(false) {
+        int n_workers = options.n_workers > 0 ? options.n_workers
+                                              : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        queues_.reserve(n_workers);
+        for (int w = 0; w < n_workers; ++w) queues_.emplace_back(new WorkerQueue());
+
+        jobs_.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            jobs_.emplace_back(new FileJob());
+            jobs_.back()->result.index = i;
+            jobs_.back()->result.path = paths[i];
+            jobs_.back()->chunks_left = 0;
+            jobs_.back()->failed = false;
+        }
+        // deal files round robin, last ones pushed first so every worker starts on its earliest file
+        for (size_t i = paths.size(); i-- > 0;)
+            queues_[i % n_workers]->tasks.push_back({jobs_[i].get(), 0, -1});
+    }
+
+    void run() {
+        if (jobs_.empty()) return;
+        std::vector<std::thread> workers;
+        for (size_t w = 1; w < queues_.size(); ++w) workers.emplace_back(&BatchRun::work, this, w);
+        work(0);
+        for (std::thread& t : workers) t.join();
+        if (callback_error_) std::rethrow_exception(callback_error_);
+    }
+
+private:
+    bool popOwn(size_t w, Task& task) {
+        WorkerQueue& q = *queues_[w];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t w, Task& task) {
+        for (size_t k = 1; k < queues_.size(); ++k) {
+            WorkerQueue& q = *queues_[(w + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            task = q.tasks.front();
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t w) {
+        std::map<int, std::unique_ptr<Extractor>> extractors;  // by sample rate
+        Task task;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            if (popOwn(w, task) || steal(w, task)) {
+                if (task.count < 0) decode(w, task.job, extractors);
+                else chunk(task, extractors);
+                if (pending_.fetch_sub(1) == 1) idle_cv_.notify_all();
+                continue;
+            }
+            if (pending_.load() == 0) return;
+            // everything left is being decoded or computed elsewhere; a decode may still push chunks
+            std::unique_lock<std::mutex> lock(idle_mutex_);
+            idle_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    Extractor& extractorFor(int sample_rate, std::map<int, std::unique_ptr<Extractor>>& extractors) {
+        std::unique_ptr<Extractor>& e = extractors[sample_rate];
+        if (!e) {
+            e.reset(new Extractor(fileConfig(sample_rate)));
+        }
+        return *e;
+    }
+
+    void decode(size_t w, FileJob* job, std::map<int, std::unique_ptr<Extractor>>& extractors) {
+        FileFeatures& r = job->result;
+        try {
+            FeatureCache* cache = cache_;
+            if (cache && cache->options().key == CacheKeyMode::FileIdentity) {
+                // a hit needs only the header: nothing is decoded
+                WavFileInfo info;
+                if (!get_wav_info(r.path, info)) throw std::runtime_error("Cannot open " + r.path);
+                r.sample_rate = info.sample_rate;
+                r.n_samples = static_cast<size_t>(info.frames);
+                job->cache_key = file_identity_hash(r.path);
+                if (cachedResult(job)) return;
+            }
+            std::pair<std::vector<float>, int> wav = get_wav_mono(r.path);
+            job->mono = std::move(wav.first);
+            r.sample_rate = wav.second;
+            r.n_samples = job->mono.size();
+            if (cache && cache->options().key == CacheKeyMode::Content) {
+                job->cache_key = audio_hash(job->mono.data(), job->mono.size(), r.sample_rate);
+                if (cachedResult(job)) return;
+            }
+
+            Extractor& extractor = extractorFor(r.sample_rate, extractors);
+            const int n_frames = extractor.numFrames(job->mono.size());
+            extractor.allocate(r.features, n_frames);
+            const int n_chunks = (n_frames + chunk_frames_ - 1) / chunk_frames_;
+            if (n_chunks == 0) {
+                r.ok = true;
+                finish(job);
+                return;
+            }
+            job->chunks_left = n_chunks;
+            pending_.fetch_add(n_chunks);
+            {
+                // last chunk pushed first: this worker continues at the front of the file
+                WorkerQueue& q = *queues_[w];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                for (int c = n_chunks; c-- > 0;) {
+                    int first = c * chunk_frames_;
+                    q.tasks.push_back({job, first, std::min(chunk_frames_, n_frames - first)});
+                }
+            }
+            idle_cv_.notify_all();
+        } catch (const std::bad_alloc&) {
+            fail(job, "out of memory");
+        } catch (const std::exception& e) {
+            fail(job, e.what());
+        }
+    }
+
+    ExtractorConfig fileConfig(int sample_rate) const {
+        ExtractorConfig config = config_;
+        config.sample_rate = sample_rate;
+        return config;
+    }
+
+    // finishes the job from the cache on a hit
+    bool cachedResult(FileJob* job) {
+        FileFeatures& r = job->result;
+        if (!cache_->lookup(job->cache_key, fileConfig(r.sample_rate), r.features)) return false;
+        job->cached = true;
+        r.ok = true;
+        finish(job);
+        return true;
+    }
+
+    void chunk(const Task& task, std::map<int, std::unique_ptr<Extractor>>& extractors) {
+        FileJob* job = task.job;
+        FileFeatures& r = job->result;
+        if (job->failed.load()) {
+            // another chunk of this file already failed, only the bookkeeping is left
+            if (job->chunks_left.fetch_sub(1) == 1) finish(job);
+            return;
+        }
+        try {
+            extractorFor(r.sample_rate, extractors)
+                .processRange(job->mono.data(), job->mono.size(), task.first, task.count, r.features);
+        } catch (const std::exception& e) {
+            if (!job->failed.exchange(true)) r.error = e.what();
+        }
+        if (job->chunks_left.fetch_sub(1) == 1) {
+            r.ok = r.error.empty();
+            finish(job);
+        }
+    }
+
+    void fail(FileJob* job, const std::string& message) {
+        job->result.ok = false;
+        job->result.error = message;
+        job->result.features = FeatureSet();
+        finish(job);
+    }
+
+    // hands the file to the callback and drops everything the job still holds
+    void finish(FileJob* job) {
+        std::vector<float>().swap(job->mono);
+        if (!job->result.ok) job->result.features = FeatureSet();
+        if (cache_ && job->result.ok && !job->cached) {
+            try {
+                cache_->store(job->cache_key, fileConfig(job->result.sample_rate), job->result.features.n_bins,
+                              job->result.features);
+            } catch (const std::exception&) {
+                // a full or read-only cache directory costs the reuse, not the result
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(emit_mutex_);
+            if (!stop_.load()) {
+                try {
+                    if (!on_file_(job->result)) stop_ = true;
+                } catch (...) {
+                    callback_error_ = std::current_exception();
+                    stop_ = true;
+                }
+            }
+        }
+        job->result = FileFeatures();
+        if (stop_.load()) idle_cv_.notify_all();
+    }
+
+    ExtractorConfig config_;
+    const FileCallback& on_file_;
+    FeatureCache* cache_;
+    int chunk_frames_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::unique_ptr<FileJob>> jobs_;
+    std::atomic<size_t> pending_;  // tasks queued or running
+    std::atomic<bool> stop_;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    std::mutex emit_mutex_;        // serializes the callback
+    std::exception_ptr callback_error_;
+};
+
+} // namespace
+
+void extract_files(const std::vector<std::string>& paths, const ExtractorConfig& config,
+                   const BatchOptions& options, const FileCallback& on_file) {
+    Extractor check(config);  // invalid configs throw here, not once per file
+    (void)check;
+    BatchRun batch(paths, config, options, on_file);
+    batch.run();
+}
+
+std::vector<FileFeatures> extract_files(const std::vector<std::string>& paths, const ExtractorConfig& config,
+                                        int n_workers) {
+    std::vector<FileFeatures> results(paths.size());
+    BatchOptions options;
+    options.n_workers = n_workers;
+    extract_files(paths, config, options, [&results](FileFeatures& file) {
+        size_t index = file.index;
+        results[index] = std::move(file);
+        return true;
+    });
+    return results;
+}
+
+FileFeatureStream::FileFeatureStream(const std::vector<std::string>& paths, const ExtractorConfig& config,
+                                     const BatchOptions& options, size_t max_ready)
+    : max_ready_(std::max<size_t>(1, max_ready)), done_(false), stopped_(false) {
+    Extractor check(config);
+    (void)check;
+    runner_ = std::thread([this, paths, config, options] {
+        std::string error;
+        try {
+            extract_files(paths, config, options, [this](FileFeatures& file) { return push(file); });
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = error;
+        done_ = true;
+        ready_cv_.notify_all();
+    });
+}
+
+FileFeatureStream::~FileFeatureStream() {
+    stop();
+    if (runner_.joinable()) runner_.join();
+}
+
+bool FileFeatureStream::push(FileFeatures& file) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_cv_.wait(lock, [this] { return ready_.size() < max_ready_ || stopped_; });
+    if (stopped_) return false;
+    ready_.push_back(std::move(file));
+    ready_cv_.notify_one();
+    return true;
+}
+
+bool FileFeatureStream::next(FileFeatures& out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_cv_.wait(lock, [this] { return !ready_.empty() || done_; });
+    if (!ready_.empty()) {
+        out = std::move(ready_.front());
+        ready_.pop_front();
+        space_cv_.notify_one();
+        return true;
+    }
+    if (!error_.empty()) {
+        std::string error;
+        error.swap(error_);
+        throw std::runtime_error(error);
+    }
+    return false;
+}
+
+void FileFeatureStream::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    space_cv_.notify_all();
+}
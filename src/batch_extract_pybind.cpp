@@ -0,0 +1,73 @@
+// Python bindings for batch extraction over many files
+// extract_files() returns an iterator; files come out as they finish, the GIL is released while waiting
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <batch_extract.hpp>
+
+namespace py = pybind11;
+
+// extractor_pybind.cpp
+py::dict feature_dict(FeatureSet& out, const ExtractorConfig& config);
+
+namespace {
+
+// the stream plus the settings feature_dict needs to shape the arrays
+struct BatchIterator {
+    BatchIterator(const std::vector<std::string>& paths, const ExtractorConfig& config, const BatchOptions& options,
+                  size_t max_ready, py::object cache)
+        : config(config), cache(cache), stream(paths, config, options, max_ready) {}
+    ExtractorConfig config;
+    py::object cache;  // the FeatureCache the workers use outlives them
+    FileFeatureStream stream;
+};
+
+} // namespace
+
+void bind_batch_extract(py::module_& m) {
+    py::class_<BatchIterator>(m, "FileFeatureStream", "Iterator over the files of an extract_files() batch")
+        .def("__iter__", [](BatchIterator& self) -> BatchIterator& { return self; })
+        .def("__next__", [](BatchIterator& self) {
+                 FileFeatures file;
+                 bool more;
+                 {
+                     py::gil_scoped_release release;
+                     more = self.stream.next(file);
+                 }
+                 if (!more) throw py::stop_iteration();
+                 py::dict features;
+                 if (file.ok) {
+                     ExtractorConfig config = self.config;
+                     config.sample_rate = file.sample_rate;
+                     features = feature_dict(file.features, config);
+                     features["sample_rate"] = file.sample_rate;
+                 } else {
+                     features["error"] = file.error;
+                 }
+                 return py::make_tuple(file.index, file.path, features);
+             })
+        .def("stop", [](BatchIterator& self) {
+                 py::gil_scoped_release release;
+                 self.stream.stop();
+             }, "Stop scheduling work; files already finished are still returned");
+
+    m.def("extract_files", [](const std::vector<std::string>& paths, const Extractor& extractor, int n_workers,
+                              int chunk_frames, size_t max_ready, py::object cache) {
+              BatchOptions options;
+              options.n_workers = n_workers;
+              options.chunk_frames = chunk_frames;
+              if (!cache.is_none()) options.cache = cache.cast<FeatureCache*>();
+              return std::unique_ptr<BatchIterator>(
+                  new BatchIterator(paths, extractor.config(), options, max_ready, cache));
+          },
+          py::arg("paths"), py::arg("extractor"), py::arg("n_workers") = 0, py::arg("chunk_frames") = 2048,
+          py::arg("max_ready") = 4, py::arg("cache") = py::none(),
+          "Features of many WAV files on a work-stealing thread pool, using extractor's settings "
+          "(each file at its own sample rate, multichannel files averaged to mono). "
+          "Yields (index, path, features) as files finish; a file that failed has only an 'error' key. "
+          "With a FeatureCache, files it already holds are read back instead of extracted");
+}
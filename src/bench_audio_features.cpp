@@ -0,0 +1,269 @@
+/**
+ * Microbenchmarks for the FFT / feature kernels in fft_stft.cpp and time_features.cpp
+ * sweeps window size, hop and signal length and prints one JSON object (or CSV row) per measurement
+ * so results can be diffed between releases.
+ *
+ * BUILD (CMake target)
+ *   cmake --build build --target bench_audio_features
+ *
+ * RUN
+ *   ./build/bench_audio_features                       # full sweep, JSON lines on stdout
+ *   ./build/bench_audio_features --quick --format csv  # small sweep, CSV
+ *   ./build/bench_audio_features --win 1024 --hop 256 --seconds 10 --sample-rate 16000
+ *
+ * FIELDS
+ *   kernel, sample_rate, win_len, hop_len, signal_s, frames, repeats,
+ *   ns_per_frame      median time of one call divided by the frames it processes
+ *   msamples_per_s    input samples processed per second (millions)
+ *   realtime_factor   seconds of audio processed per second of wall time
+ *   allocs_per_frame  heap allocations (operator new) of one call divided by its frames
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <alloc_counter.hpp>
+#include <fft_stft.hpp>
+#include <time_features.hpp>
+
+namespace {
+
+struct BenchOptions {
+    std::vector<int> win_lens = {256, 512, 1024, 2048, 4096, 8192};
+    std::vector<int> hop_divs = {4, 2};           // hop = win_len / div
+    std::vector<double> seconds = {1.0, 10.0, 60.0};
+    int sample_rate = 44100;
+    int repeats = 5;
+    double min_time = 0.05;                       // each repeat runs the kernel for at least this long
+    std::string format = "json";
+};
+
+struct Result {
+    std::string kernel;
+    int win_len;
+    int hop_len;
+    double signal_s;
+    int frames;
+    int repeats;
+    double ns_per_frame;
+    double msamples_per_s;
+    double realtime_factor;
+    double allocs_per_frame;
+};
+
+// keep the optimizer from discarding results
+volatile double g_sink = 0.0;
+
+std::vector<int> parse_int_list(const char* arg) {
+    std::vector<int> values;
+    for (const char* p = arg; *p; ) {
+        values.push_back(std::atoi(p));
+        p = std::strchr(p, ',');
+        if (!p) break;
+        ++p;
+    }
+    return values;
+}
+
+std::vector<double> parse_double_list(const char* arg) {
+    std::vector<double> values;
+    for (const char* p = arg; *p; ) {
+        values.push_back(std::atof(p));
+        p = std::strchr(p, ',');
+        if (!p) break;
+        ++p;
+    }
+    return values;
+}
+
+// tones plus a little noise, deterministic
+std::vector<float> make_signal(int sample_rate, double seconds) {
+    size_t n = static_cast<size_t>(sample_rate * seconds);
+    std::vector<float> sig(n);
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    for (size_t i = 0; i < n; ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        sig[i] = 0.4f * std::sin(2 * M_PI * 440.0 * t) + 0.2f * std::sin(2 * M_PI * 3520.0 * t) + noise(rng);
+    }
+    return sig;
+}
+
+// allocations made by a single call
+uint64_t count_allocs(const std::function<void()>& fn) {
+    AllocScope scope;
+    fn();
+    return scope.stats().allocs;
+}
+
+// median over `repeats` of the mean call time, each repeat loops until min_time has elapsed
+// the warm-up call (plans, caches) is also the one whose allocations are counted
+double time_call(const std::function<void()>& fn, int repeats, double min_time, uint64_t& allocs) {
+    using clock = std::chrono::steady_clock;
+    allocs = count_allocs(fn);
+    std::vector<double> samples;
+    for (int r = 0; r < repeats; ++r) {
+        int calls = 0;
+        clock::time_point t0 = clock::now();
+        double elapsed = 0.0;
+        do {
+            fn();
+            ++calls;
+            elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+        } while (elapsed < min_time);
+        samples.push_back(elapsed / calls);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void print_result(const Result& r, const BenchOptions& opt, bool& header_done) {
+    if (opt.format == "csv") {
+        if (!header_done) {
+            std::printf("kernel,sample_rate,win_len,hop_len,signal_s,frames,repeats,ns_per_frame,msamples_per_s,"
+                        "realtime_factor,allocs_per_frame\n");
+            header_done = true;
+        }
+        std::printf("%s,%d,%d,%d,%.3f,%d,%d,%.1f,%.3f,%.2f,%.3f\n", r.kernel.c_str(), opt.sample_rate, r.win_len,
+                    r.hop_len, r.signal_s, r.frames, r.repeats, r.ns_per_frame, r.msamples_per_s, r.realtime_factor,
+                    r.allocs_per_frame);
+    } else {
+        std::printf("{\"kernel\": \"%s\", \"sample_rate\": %d, \"win_len\": %d, \"hop_len\": %d, \"signal_s\": %.3f, "
+                    "\"frames\": %d, \"repeats\": %d, \"ns_per_frame\": %.1f, \"msamples_per_s\": %.3f, "
+                    "\"realtime_factor\": %.2f, \"allocs_per_frame\": %.3f}\n",
+                    r.kernel.c_str(), opt.sample_rate, r.win_len, r.hop_len, r.signal_s, r.frames, r.repeats,
+                    r.ns_per_frame, r.msamples_per_s, r.realtime_factor, r.allocs_per_frame);
+    }
+    std::fflush(stdout);
+}
+
+Result make_result(const std::string& kernel, int win_len, int hop_len, double signal_s, int frames,
+                   double seconds_per_call, uint64_t allocs, const BenchOptions& opt) {
+    Result r;
+    r.kernel = kernel;
+    r.win_len = win_len;
+    r.hop_len = hop_len;
+    r.signal_s = signal_s;
+    r.frames = frames;
+    r.repeats = opt.repeats;
+    r.ns_per_frame = seconds_per_call * 1e9 / std::max(frames, 1);
+    double samples = signal_s * opt.sample_rate;
+    r.msamples_per_s = samples / seconds_per_call * 1e-6;
+    r.realtime_factor = signal_s / seconds_per_call;
+    r.allocs_per_frame = static_cast<double>(allocs) / std::max(frames, 1);
+    return r;
+}
+
+void usage() {
+    std::cerr << "usage: bench_audio_features [--quick] [--format json|csv] [--sample-rate N]\n"
+                 "                            [--win a,b,...] [--hop-div a,b,...] [--hop N] [--seconds a,b,...]\n"
+                 "                            [--repeats N] [--min-time SEC]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    int fixed_hop = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--quick") {
+            opt.win_lens = {512, 2048};
+            opt.hop_divs = {2};
+            opt.seconds = {1.0};
+            opt.repeats = 3;
+        } else if (a == "--format" && has_value) opt.format = argv[++i];
+        else if (a == "--sample-rate" && has_value) opt.sample_rate = std::atoi(argv[++i]);
+        else if (a == "--win" && has_value) opt.win_lens = parse_int_list(argv[++i]);
+        else if (a == "--hop-div" && has_value) opt.hop_divs = parse_int_list(argv[++i]);
+        else if (a == "--hop" && has_value) fixed_hop = std::atoi(argv[++i]);
+        else if (a == "--seconds" && has_value) opt.seconds = parse_double_list(argv[++i]);
+        else if (a == "--repeats" && has_value) opt.repeats = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--min-time" && has_value) opt.min_time = std::atof(argv[++i]);
+        else {
+            usage();
+            return a == "--help" || a == "-h" ? 0 : 1;
+        }
+    }
+    if (opt.format != "json" && opt.format != "csv") {
+        usage();
+        return 1;
+    }
+
+    bool header_done = false;
+    uint64_t allocs = 0;
+
+    for (double seconds : opt.seconds) {
+        std::vector<float> sig = make_signal(opt.sample_rate, seconds);
+        std::vector<double> sig_d(sig.begin(), sig.end());
+
+        for (int win_len : opt.win_lens) {
+            if (static_cast<size_t>(win_len) > sig.size()) continue;
+
+            // single-frame FFT (independent of hop and signal length, so only once per window size)
+            if (seconds == opt.seconds.front()) {
+                std::vector<double> frame(sig_d.begin(), sig_d.begin() + win_len);
+                double t = time_call([&] { g_sink = compute_fft(frame)[1].real(); },
+                                     opt.repeats, opt.min_time, allocs);
+                print_result(make_result("compute_fft", win_len, win_len,
+                                         static_cast<double>(win_len) / opt.sample_rate, 1, t, allocs, opt),
+                             opt, header_done);
+            }
+
+            std::vector<int> hops;
+            if (fixed_hop > 0) hops.push_back(fixed_hop);
+            else for (int div : opt.hop_divs) hops.push_back(std::max(1, win_len / div));
+
+            for (int hop_len : hops) {
+                int frames = static_cast<int>((sig.size() - win_len) / hop_len + 1);
+
+                double t = time_call([&] { g_sink = compute_stft(sig_d, win_len, hop_len).size(); },
+                                     opt.repeats, opt.min_time, allocs);
+                print_result(make_result("compute_stft", win_len, hop_len, seconds, frames, t, allocs, opt), opt, header_done);
+
+                std::vector<std::vector<double>> stft = compute_stft(sig_d, win_len, hop_len);
+
+                t = time_call([&] { g_sink = compute_spectral_centroid(stft, opt.sample_rate, win_len)[0]; },
+                              opt.repeats, opt.min_time, allocs);
+                print_result(make_result("compute_spectral_centroid", win_len, hop_len, seconds, frames, t, allocs, opt),
+                             opt, header_done);
+
+                t = time_call([&] { g_sink = compute_spectral_rolloff(stft, opt.sample_rate, win_len, 0.99)[0]; },
+                              opt.repeats, opt.min_time, allocs);
+                print_result(make_result("compute_spectral_rolloff", win_len, hop_len, seconds, frames, t, allocs, opt),
+                             opt, header_done);
+
+                t = time_call([&] { g_sink = compute_mfcc(stft, opt.sample_rate, win_len, 26, 13)[0][0]; },
+                              opt.repeats, opt.min_time, allocs);
+                print_result(make_result("compute_mfcc", win_len, hop_len, seconds, frames, t, allocs, opt), opt, header_done);
+
+                // framewise RMS / ZCR, the way test_audio_features.py calls them
+                t = time_call([&] {
+                    double acc = 0.0;
+                    for (int f = 0; f < frames; ++f) acc += calc_rms(sig.data() + f * hop_len, win_len);
+                    g_sink = acc;
+                }, opt.repeats, opt.min_time, allocs);
+                print_result(make_result("calc_rms", win_len, hop_len, seconds, frames, t, allocs, opt), opt, header_done);
+
+                t = time_call([&] {
+                    double acc = 0.0;
+                    for (int f = 0; f < frames; ++f) acc += calc_zcr(sig.data() + f * hop_len, win_len);
+                    g_sink = acc;
+                }, opt.repeats, opt.min_time, allocs);
+                print_result(make_result("calc_zcr", win_len, hop_len, seconds, frames, t, allocs, opt), opt, header_done);
+            }
+        }
+    }
+    return 0;
+}
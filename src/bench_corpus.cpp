@@ -0,0 +1,243 @@
+/**
+ * End-to-end realtime-factor benchmark over a directory of audio files
+ * runs the same chain the Python module exposes: get_wav_data -> compute_stft ->
+ * centroid / rolloff / mfcc, plus framewise calc_rms / calc_zcr, on N worker threads.
+ *
+ * BUILD (CMake target)
+ *   cmake --build build --target bench_corpus
+ *
+ * RUN
+ *   ./build/bench_corpus data/ --threads 8
+ *   ./build/bench_corpus /corpus --threads 4 --win 2048 --hop 512 --format json
+ *
+ * REPORTS
+ *   per-stage wall time (summed over threads and as a share of the total), files/s,
+ *   audio hours per wall hour (realtime factor) and peak RSS
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <fft_stft.hpp>
+#include <time_features.hpp>
+#include <wav_io.hpp>
+
+namespace {
+
+enum Stage { DECODE, CONVERT, STFT, CENTROID, ROLLOFF, MFCC, RMS_ZCR, NUM_STAGES };
+const char* kStageNames[NUM_STAGES] = {"decode", "convert", "stft", "centroid", "rolloff", "mfcc", "rms_zcr"};
+
+struct CorpusOptions {
+    std::string root;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int win_len = 1024;
+    int hop_len = 512;
+    int n_mel = 26;
+    int n_mfcc = 13;
+    double rolloff_pct = 0.99;
+    std::string format = "text";
+};
+
+struct CorpusFile {
+    std::string path;
+    off_t bytes;
+};
+
+// per-thread totals, merged after join
+struct WorkerStats {
+    double stage_s[NUM_STAGES] = {0};
+    double audio_s = 0.0;
+    long files = 0;
+    long failed = 0;
+    long frames = 0;
+};
+
+bool has_audio_extension(const std::string& name) {
+    static const char* exts[] = {".wav", ".flac", ".ogg", ".aif", ".aiff", ".au"};
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    for (const char* ext : exts) {
+        std::string e = ext;
+        if (lower.size() >= e.size() && lower.compare(lower.size() - e.size(), e.size(), e) == 0) return true;
+    }
+    return false;
+}
+
+void walk(const std::string& dir, std::vector<CorpusFile>& files) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        std::cerr << "Cannot open directory " << dir << "\n";
+        return;
+    }
+    while (dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+        std::string path = dir + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) walk(path, files);
+        else if (S_ISREG(st.st_mode) && has_audio_extension(name)) files.push_back({path, st.st_size});
+    }
+    closedir(d);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void process_file(const CorpusFile& file, const CorpusOptions& opt, WorkerStats& stats) {
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point t = clock::now();
+    WavFileInfo info;
+    std::pair<std::vector<float>, int> wav = get_wav_data(file.path);
+    bool ok = !wav.first.empty() && get_wav_info(file.path, info);
+    stats.stage_s[DECODE] += seconds_since(t);
+    if (!ok || wav.first.size() < static_cast<size_t>(opt.win_len)) {
+        ++stats.failed;
+        return;
+    }
+    const std::vector<float>& signal = wav.first;
+    int sample_rate = wav.second;
+
+    // the Python module converts list[float] -> std::vector<double> at the binding
+    t = clock::now();
+    std::vector<double> signal_d(signal.begin(), signal.end());
+    stats.stage_s[CONVERT] += seconds_since(t);
+
+    t = clock::now();
+    std::vector<std::vector<double>> stft = compute_stft(signal_d, opt.win_len, opt.hop_len);
+    stats.stage_s[STFT] += seconds_since(t);
+
+    t = clock::now();
+    std::vector<double> centroid = compute_spectral_centroid(stft, sample_rate, opt.win_len);
+    stats.stage_s[CENTROID] += seconds_since(t);
+
+    t = clock::now();
+    std::vector<double> rolloff = compute_spectral_rolloff(stft, sample_rate, opt.win_len, opt.rolloff_pct);
+    stats.stage_s[ROLLOFF] += seconds_since(t);
+
+    t = clock::now();
+    std::vector<std::vector<double>> mfcc = compute_mfcc(stft, sample_rate, opt.win_len, opt.n_mel, opt.n_mfcc);
+    stats.stage_s[MFCC] += seconds_since(t);
+
+    t = clock::now();
+    volatile float sink = 0.0f;
+    for (size_t f = 0; f < stft.size(); ++f) {
+        const float* frame = signal.data() + f * opt.hop_len;
+        sink = sink + calc_rms(frame, opt.win_len) + calc_zcr(frame, opt.win_len);
+    }
+    stats.stage_s[RMS_ZCR] += seconds_since(t);
+
+    stats.audio_s += static_cast<double>(info.frames) / info.sample_rate;
+    stats.frames += static_cast<long>(stft.size());
+    ++stats.files;
+}
+
+long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;  // kilobytes on Linux
+}
+
+void usage() {
+    std::cerr << "usage: bench_corpus <dir> [--threads N] [--win N] [--hop N] [--n-mel N] [--n-mfcc N]\n"
+                 "                    [--rolloff PCT] [--format text|json]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CorpusOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--threads" && has_value) opt.threads = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--win" && has_value) opt.win_len = std::atoi(argv[++i]);
+        else if (a == "--hop" && has_value) opt.hop_len = std::atoi(argv[++i]);
+        else if (a == "--n-mel" && has_value) opt.n_mel = std::atoi(argv[++i]);
+        else if (a == "--n-mfcc" && has_value) opt.n_mfcc = std::atoi(argv[++i]);
+        else if (a == "--rolloff" && has_value) opt.rolloff_pct = std::atof(argv[++i]);
+        else if (a == "--format" && has_value) opt.format = argv[++i];
+        else if (!a.empty() && a[0] != '-' && opt.root.empty()) opt.root = a;
+        else {
+            usage();
+            return a == "--help" || a == "-h" ? 0 : 1;
+        }
+    }
+    if (opt.root.empty() || opt.win_len <= 0 || opt.hop_len <= 0) {
+        usage();
+        return 1;
+    }
+
+    std::vector<CorpusFile> files;
+    walk(opt.root, files);
+    if (files.empty()) {
+        std::cerr << "No audio files under " << opt.root << "\n";
+        return 1;
+    }
+    // largest first so one long recording doesn't finish last on its own
+    std::sort(files.begin(), files.end(), [](const CorpusFile& a, const CorpusFile& b) { return a.bytes > b.bytes; });
+
+    std::vector<WorkerStats> per_thread(opt.threads);
+    std::atomic<size_t> next(0);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int w = 0; w < opt.threads; ++w) {
+        workers.emplace_back([&, w] {
+            for (size_t i = next++; i < files.size(); i = next++)
+                process_file(files[i], opt, per_thread[w]);
+        });
+    }
+    for (std::thread& t : workers) t.join();
+    double wall_s = seconds_since(t0);
+
+    WorkerStats total;
+    for (const WorkerStats& s : per_thread) {
+        for (int k = 0; k < NUM_STAGES; ++k) total.stage_s[k] += s.stage_s[k];
+        total.audio_s += s.audio_s;
+        total.files += s.files;
+        total.failed += s.failed;
+        total.frames += s.frames;
+    }
+    double busy_s = 0.0;
+    for (int k = 0; k < NUM_STAGES; ++k) busy_s += total.stage_s[k];
+
+    double rtf = total.audio_s / wall_s;
+    double files_per_s = total.files / wall_s;
+    long rss = peak_rss_kb();
+
+    if (opt.format == "json") {
+        std::printf("{\"root\": \"%s\", \"threads\": %d, \"win_len\": %d, \"hop_len\": %d, \"files\": %ld, "
+                    "\"failed\": %ld, \"frames\": %ld, \"audio_s\": %.3f, \"wall_s\": %.3f, \"files_per_s\": %.3f, "
+                    "\"realtime_factor\": %.2f, \"peak_rss_kb\": %ld, \"stages\": {",
+                    opt.root.c_str(), opt.threads, opt.win_len, opt.hop_len, total.files, total.failed, total.frames,
+                    total.audio_s, wall_s, files_per_s, rtf, rss);
+        for (int k = 0; k < NUM_STAGES; ++k)
+            std::printf("%s\"%s\": %.4f", k ? ", " : "", kStageNames[k], total.stage_s[k]);
+        std::printf("}}\n");
+    } else {
+        std::printf("files          %ld ok, %ld failed (%d threads)\n", total.files, total.failed, opt.threads);
+        std::printf("audio          %.1f s (%.3f h)\n", total.audio_s, total.audio_s / 3600.0);
+        std::printf("wall           %.3f s\n", wall_s);
+        std::printf("files/s        %.2f\n", files_per_s);
+        std::printf("realtime       %.1fx (audio hours per wall hour)\n", rtf);
+        std::printf("peak RSS       %.1f MB\n", rss / 1024.0);
+        std::printf("stage          thread-seconds   share\n");
+        for (int k = 0; k < NUM_STAGES; ++k)
+            std::printf("  %-12s %12.4f  %5.1f%%\n", kStageNames[k], total.stage_s[k],
+                        busy_s > 0 ? 100.0 * total.stage_s[k] / busy_s : 0.0);
+    }
+    return total.files > 0 ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+// Stateful feature extractor, see extractor.hpp
+// every table and buffer is built in the constructor; process() only resizes the output arrays
+
+#include <extractor.hpp>
+#include <time_features.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+ExtractorConfig validated(ExtractorConfig config) {
+    if (config.win_len == 0) config.win_len = config.n_fft;
+    if (config.sample_rate <= 0) throw std::invalid_argument("sample_rate must be positive");
+    if (config.n_fft < 2 || config.hop_len <= 0)
+        throw std::invalid_argument("n_fft must be at least 2 and hop_len positive");
+    if (config.win_len < 2 || config.win_len > config.n_fft)
+        throw std::invalid_argument("win_len must be in [2, n_fft]");
+    if (config.n_mel <= 0 || config.n_mfcc <= 0 || config.n_mfcc > config.n_mel)
+        throw std::invalid_argument("n_mfcc must be in (0, n_mel]");
+    if ((config.features & FEATURE_ALL) == 0 || (config.features & ~FEATURE_ALL) != 0)
+        throw std::invalid_argument("features must select at least one known feature");
+    return config;
+}
+
+} // namespace
+
+uint64_t config_hash(const ExtractorConfig& config) {
+    const ExtractorConfig c = validated(config);
+    char text[512];
+    std::snprintf(text, sizeof(text), "sr=%d n_fft=%d win=%d hop=%d center=%d pad=%s window=%s periodic=%d "
+                  "beta=%.17g spectrum=%s n_mel=%d n_mfcc=%d rolloff=%.17g features=%u",
+                  c.sample_rate, c.n_fft, c.win_len, c.hop_len, c.center ? 1 : 0, pad_mode_name(c.pad_mode),
+                  window_type_name(c.window.type), c.window.periodic ? 1 : 0, c.window.beta,
+                  spectrum_type_name(c.spectrum), c.n_mel, c.n_mfcc, c.rolloff_pct, c.features);
+    uint64_t hash = 1469598103934665603ull;
+    for (const char* p = text; *p; ++p) {
+        hash ^= static_cast<unsigned char>(*p);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+unsigned parse_features(const std::vector<std::string>& names) {
+    unsigned features = 0;
+    for (const std::string& name : names) {
+        if (name == "spectrum") features |= FEATURE_SPECTRUM;
+        else if (name == "centroid") features |= FEATURE_CENTROID;
+        else if (name == "rolloff") features |= FEATURE_ROLLOFF;
+        else if (name == "mfcc") features |= FEATURE_MFCC;
+        else if (name == "rms") features |= FEATURE_RMS;
+        else if (name == "zcr") features |= FEATURE_ZCR;
+        else throw std::invalid_argument("Unknown feature: " + name);
+    }
+    return features;
+}
+
+Extractor::Extractor(const ExtractorConfig& config)
+    : config_(validated(config)),
+      framing_{config_.n_fft, config_.hop_len, config_.center, config_.pad_mode},
+      spectrum_(config_.win_len, config_.n_fft, config_.window),
+      mfcc_(config_.sample_rate, config_.n_fft, config_.n_mel, config_.n_mfcc, config_.spectrum),
+      bin_hz_(static_cast<double>(config_.sample_rate) / config_.n_fft),
+      spectrum_row_(spectrum_values(config_.spectrum, spectrum_.bins())),
+      magnitude_(spectrum_.bins()),
+      frame_f_(config_.n_fft),
+      scratch_f_(config_.n_fft),
+      scratch_d_(config_.n_fft),
+      stream_(config_.win_len, config_.hop_len, config_.n_fft, config_.center, config_.pad_mode, config_.window,
+              config_.spectrum) {
+}
+
+int Extractor::numFrames(size_t n_samples) const {
+    return framing_.numFrames(n_samples);
+}
+
+void Extractor::allocate(FeatureSet& out, int n_frames) const {
+    const unsigned f = config_.features;
+    out.n_frames = n_frames;
+    out.n_bins = f & FEATURE_SPECTRUM ? spectrum_.bins() : 0;
+    out.n_mfcc = f & FEATURE_MFCC ? config_.n_mfcc : 0;
+    out.spectrum.resize(static_cast<size_t>(n_frames) * spectrum_values(config_.spectrum, out.n_bins));
+    out.centroid.resize(f & FEATURE_CENTROID ? n_frames : 0);
+    out.rolloff.resize(f & FEATURE_ROLLOFF ? n_frames : 0);
+    out.mfcc.resize(static_cast<size_t>(n_frames) * out.n_mfcc);
+    out.rms.resize(f & FEATURE_RMS ? n_frames : 0);
+    out.zcr.resize(f & FEATURE_ZCR ? n_frames : 0);
+}
+
+const float* Extractor::timeFrame(const double* frame) {
+    std::copy(frame, frame + config_.n_fft, frame_f_.begin());
+    return frame_f_.data();
+}
+
+// every requested feature of one frame (n_fft samples) into row `row` of out
+template <typename T>
+void Extractor::processFrame(const T* frame, FeatureSet& out, size_t row) {
+    const unsigned f = config_.features;
+    const int n_fft = config_.n_fft;
+    const int bins = spectrum_.bins();
+    const int row_len = spectrum_values(config_.spectrum, bins);
+    const bool need_magnitude = (f & (FEATURE_CENTROID | FEATURE_ROLLOFF)) != 0;
+    const bool need_spectrum = (f & (FEATURE_SPECTRUM | FEATURE_CENTROID | FEATURE_ROLLOFF | FEATURE_MFCC)) != 0;
+
+    if (f & (FEATURE_RMS | FEATURE_ZCR)) {
+        const float* samples = timeFrame(frame);
+        if (f & FEATURE_RMS) out.rms[row] = calc_rms(samples, n_fft);
+        if (f & FEATURE_ZCR) out.zcr[row] = calc_zcr(samples, n_fft);
+    }
+    if (!need_spectrum) return;
+
+    double* spec = f & FEATURE_SPECTRUM ? out.spectrum.data() + row * row_len : spectrum_row_.data();
+    spectrum_.compute(frame, config_.spectrum, spec);
+    // centroid and rolloff are magnitude weighted whatever form the spectrum is returned in
+    const double* mag = spec;
+    if (need_magnitude && config_.spectrum != SpectrumType::Magnitude) {
+        spectrum_.convert(SpectrumType::Magnitude, magnitude_.data());
+        mag = magnitude_.data();
+    }
+    if (f & FEATURE_CENTROID) out.centroid[row] = spectral_centroid(mag, bins, bin_hz_);
+    if (f & FEATURE_ROLLOFF) out.rolloff[row] = spectral_rolloff(mag, bins, bin_hz_, config_.rolloff_pct);
+    if (f & FEATURE_MFCC) mfcc_.compute(spec, out.mfcc.data() + row * config_.n_mfcc);
+}
+
+// fills rows [row, row + n_frames) of out with frames [first, first + n_frames) of signal[0, n)
+template <typename T>
+void Extractor::processFrames(const T* signal, size_t n, const Framing& framing, int first, int n_frames,
+                              FeatureSet& out, size_t row) {
+    for (int t = first; t < first + n_frames; ++t, ++row)
+        processFrame(frameAt(signal, n, framing, t), out, row);
+}
+
+void Extractor::process(const float* signal, size_t n, FeatureSet& out) {
+    AF_TRACE_SCOPE("extract");
+    int n_frames = numFrames(n);
+    allocate(out, n_frames);
+    processFrames(signal, n, framing_, 0, n_frames, out, 0);
+}
+
+void Extractor::process(const double* signal, size_t n, FeatureSet& out) {
+    AF_TRACE_SCOPE("extract");
+    int n_frames = numFrames(n);
+    allocate(out, n_frames);
+    processFrames(signal, n, framing_, 0, n_frames, out, 0);
+}
+
+void Extractor::processRange(const float* signal, size_t n, int first, int count, FeatureSet& out) {
+    AF_TRACE_SCOPE("extract_range");
+    const int total = numFrames(n);
+    if (first < 0 || count < 0 || first + count > total || out.n_frames != total)
+        throw std::invalid_argument("frame range outside the clip, or out not allocated for it");
+    processFrames(signal, n, framing_, first, count, out, first);
+}
+
+int Extractor::processBatch(const float* clips, size_t n_clips, size_t stride, const size_t* lengths,
+                            FeatureSet& out) {
+    AF_TRACE_SCOPE("extract_batch");
+    int max_frames = 0;
+    for (size_t c = 0; c < n_clips; ++c) {
+        const size_t n = lengths ? lengths[c] : stride;
+        if (n > stride) throw std::invalid_argument("clip length larger than the batch row");
+        max_frames = std::max(max_frames, numFrames(n));
+    }
+    allocate(out, static_cast<int>(n_clips * max_frames));
+    // every clip shares the one plan, window and filterbank; rows past a clip's own frames stay zero
+    for (size_t c = 0; c < n_clips; ++c) {
+        const size_t n = lengths ? lengths[c] : stride;
+        const int n_frames = numFrames(n);
+        const size_t row = c * max_frames;
+        processFrames(clips + c * stride, n, framing_, 0, n_frames, out, row);
+        if (n_frames < max_frames) zeroRows(out, row + n_frames, row + max_frames);
+    }
+    return max_frames;
+}
+
+void Extractor::zeroRows(FeatureSet& out, size_t begin, size_t end) const {
+    const size_t row_len = spectrum_values(config_.spectrum, out.n_bins);
+    auto clear = [begin, end](auto& values, size_t width) {
+        if (!values.empty()) std::fill(values.begin() + begin * width, values.begin() + end * width, 0);
+    };
+    clear(out.spectrum, row_len);
+    clear(out.centroid, 1);
+    clear(out.rolloff, 1);
+    clear(out.mfcc, static_cast<size_t>(out.n_mfcc));
+    clear(out.rms, 1);
+    clear(out.zcr, 1);
+}
+
+FeatureSet Extractor::process(const std::vector<float>& signal) {
+    FeatureSet out;
+    process(signal.data(), signal.size(), out);
+    return out;
+}
+
+class Extractor::BlockRows : public StreamingStft::FrameSink {
+public:
+    BlockRows(Extractor& extractor, FeatureSet& out) : extractor_(extractor), out_(out), row_(0) {}
+    void frame(const float* samples) override { extractor_.processFrame(samples, out_, row_++); }
+    void frame(const double* samples) override { extractor_.processFrame(samples, out_, row_++); }
+
+private:
+    Extractor& extractor_;
+    FeatureSet& out_;
+    size_t row_;
+};
+
+// stream_ does the framing (carry between blocks, centering padding), the frames come back here
+template <typename T>
+void Extractor::streamBlock(const T* block, size_t n, FeatureSet& out) {
+    AF_TRACE_SCOPE("extract_block");
+    allocate(out, stream_.numFrames(n));
+    BlockRows rows(*this, out);
+    stream_.push(block, n, rows);
+}
+
+void Extractor::processBlock(const float* block, size_t n, FeatureSet& out) {
+    streamBlock(block, n, out);
+}
+
+void Extractor::processBlock(const double* block, size_t n, FeatureSet& out) {
+    streamBlock(block, n, out);
+}
+
+void Extractor::flush(FeatureSet& out) {
+    allocate(out, stream_.flushFrames());
+    BlockRows rows(*this, out);
+    stream_.flush(rows);  // resets the stream
+}
+
+void Extractor::reset() {
+    stream_.reset();
+}
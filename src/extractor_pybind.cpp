@@ -0,0 +1,185 @@
+// Python bindings for the stateful Extractor
+// results come back as a dict of NumPy arrays that take ownership of the C++ buffers (no copy)
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <pybind11/complex.h>
+#include <complex>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <extractor.hpp>
+#include <trace.hpp>
+
+namespace py = pybind11;
+
+namespace {
+
+using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// hand a vector's storage to NumPy, the capsule frees it with the array
+template <typename T>
+py::array_t<T> take_array(std::vector<T>& values, std::vector<py::ssize_t> shape) {
+    std::vector<T>* owned = new std::vector<T>(std::move(values));
+    py::capsule free_when_done(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(shape, owned->data(), free_when_done);
+}
+
+// interleaved re/im doubles handed over as a complex128 array
+py::array_t<std::complex<double>> take_complex_array(std::vector<double>& values, std::vector<py::ssize_t> shape) {
+    std::vector<double>* owned = new std::vector<double>(std::move(values));
+    py::capsule free_when_done(owned, [](void* p) { delete static_cast<std::vector<double>*>(p); });
+    return py::array_t<std::complex<double>>(shape, reinterpret_cast<std::complex<double>*>(owned->data()),
+                                             free_when_done);
+}
+
+} // namespace
+
+namespace {
+
+// arrays of out shaped lead + the per-frame shape, lead is {n_frames} or {n_clips, frames per clip}
+py::dict shaped_dict(FeatureSet& out, const ExtractorConfig& config, const std::vector<py::ssize_t>& lead) {
+    AF_TRACE_SCOPE("convert_out");
+    const unsigned features = config.features;
+    auto shape = [&lead](py::ssize_t width) {
+        std::vector<py::ssize_t> s(lead);
+        if (width) s.push_back(width);
+        return s;
+    };
+    py::dict d;
+    if (features & FEATURE_SPECTRUM) {
+        const std::vector<py::ssize_t> s = shape(out.n_bins);
+        if (config.spectrum == SpectrumType::Complex) d["spectrum"] = take_complex_array(out.spectrum, s);
+        else d["spectrum"] = take_array(out.spectrum, s);
+    }
+    if (features & FEATURE_CENTROID) d["centroid"] = take_array(out.centroid, shape(0));
+    if (features & FEATURE_ROLLOFF) d["rolloff"] = take_array(out.rolloff, shape(0));
+    if (features & FEATURE_MFCC) d["mfcc"] = take_array(out.mfcc, shape(out.n_mfcc));
+    if (features & FEATURE_RMS) d["rms"] = take_array(out.rms, shape(0));
+    if (features & FEATURE_ZCR) d["zcr"] = take_array(out.zcr, shape(0));
+    return d;
+}
+
+} // namespace
+
+// also used by the batch bindings (batch_extract_pybind.cpp)
+py::dict feature_dict(FeatureSet& out, const ExtractorConfig& config) {
+    py::dict d = shaped_dict(out, config, {static_cast<py::ssize_t>(out.n_frames)});
+    d["n_frames"] = out.n_frames;
+    return d;
+}
+
+namespace {
+
+// float32 arrays are processed as is, anything else is converted to float64 (like compute_stft)
+// the GIL stays held: an Extractor's buffers and block carry are shared by every Python thread using it
+template <typename Array, typename Fn>
+py::dict run(Extractor& self, const Array& signal, Fn fn) {
+    if (signal.ndim() != 1) throw py::value_error("signal must be one-dimensional");
+    FeatureSet out;
+    fn(self, signal.data(), static_cast<size_t>(signal.shape(0)), out);
+    return feature_dict(out, self.config());
+}
+
+} // namespace
+
+void bind_extractor(py::module_& m) {
+    py::class_<Extractor>(m, "Extractor",
+        "Feature extractor that keeps its FFT plan, window, filterbank and buffers between calls")
+        .def(py::init([](int sample_rate, int n_fft, int hop_len, int win_len, bool center, const std::string& pad_mode,
+                         const std::string& window, bool periodic, double kaiser_beta, const std::string& spectrum,
+                         int n_mel, int n_mfcc, double rolloff_pct, py::object features) {
+                 ExtractorConfig config;
+                 config.sample_rate = sample_rate;
+                 config.n_fft = n_fft;
+                 config.hop_len = hop_len;
+                 config.win_len = win_len;
+                 config.center = center;
+                 config.pad_mode = parse_pad_mode(pad_mode);
+                 config.window = make_window_spec(window, periodic, kaiser_beta);
+                 config.spectrum = parse_spectrum_type(spectrum);
+                 config.n_mel = n_mel;
+                 config.n_mfcc = n_mfcc;
+                 config.rolloff_pct = rolloff_pct;
+                 if (!features.is_none()) config.features = parse_features(features.cast<std::vector<std::string>>());
+                 return std::unique_ptr<Extractor>(new Extractor(config));
+             }),
+             py::arg("sample_rate"), py::arg("n_fft") = 1024, py::arg("hop_len") = 512, py::arg("win_len") = 0,
+             py::arg("center") = false, py::arg("pad_mode") = "constant", py::arg("window") = "hann",
+             py::arg("periodic") = false, py::arg("kaiser_beta") = 8.6, py::arg("spectrum") = "magnitude",
+             py::arg("n_mel") = 26, py::arg("n_mfcc") = 13, py::arg("rolloff_pct") = 0.99,
+             py::arg("features") = py::none())
+        .def("process", [](Extractor& self, const FloatArray& signal) {
+                 return run(self, signal, [](Extractor& e, const float* p, size_t n, FeatureSet& out) {
+                     e.process(p, n, out);
+                 });
+             }, py::arg("signal"))
+        .def("process", [](Extractor& self, const DoubleArray& signal) {
+                 return run(self, signal, [](Extractor& e, const double* p, size_t n, FeatureSet& out) {
+                     e.process(p, n, out);
+                 });
+             }, py::arg("signal"),
+             "Features of a whole clip as a dict of arrays (spectrum/mfcc are [n_frames][n])")
+        .def("process_batch", [](Extractor& self, const FloatArray& clips, py::object lengths) {
+                 if (clips.ndim() != 2) throw py::value_error("clips must be two-dimensional (clips x samples)");
+                 const size_t n_clips = static_cast<size_t>(clips.shape(0));
+                 const size_t stride = static_cast<size_t>(clips.shape(1));
+                 std::vector<size_t> clip_len;
+                 if (!lengths.is_none()) {
+                     clip_len = lengths.cast<std::vector<size_t>>();
+                     if (clip_len.size() != n_clips) throw py::value_error("lengths must have one entry per clip");
+                     for (size_t n : clip_len)
+                         if (n > stride) throw py::value_error("a clip length is larger than the clips array");
+                 }
+                 const size_t* len = lengths.is_none() ? nullptr : clip_len.data();
+                 FeatureSet out;
+                 const int frames = self.processBatch(clips.data(), n_clips, stride, len, out);
+                 std::vector<int> clip_frames(n_clips, self.numFrames(stride));
+                 for (size_t c = 0; c < clip_len.size(); ++c) clip_frames[c] = self.numFrames(clip_len[c]);
+                 py::dict d = shaped_dict(out, self.config(), {static_cast<py::ssize_t>(n_clips), frames});
+                 d["n_frames"] = py::array_t<int>(clip_frames.size(), clip_frames.data());
+                 return d;
+             }, py::arg("clips"), py::arg("lengths") = py::none(),
+             "Features of a batch of clips (a 2-D clips x samples array, lengths = valid samples per row) in one call: "
+             "arrays are [n_clips][frames][n], n_frames holds each clip's frame count, later frames are zero")
+        .def("process_block", [](Extractor& self, const FloatArray& block) {
+                 return run(self, block, [](Extractor& e, const float* p, size_t n, FeatureSet& out) {
+                     e.processBlock(p, n, out);
+                 });
+             }, py::arg("block"))
+        .def("process_block", [](Extractor& self, const DoubleArray& block) {
+                 return run(self, block, [](Extractor& e, const double* p, size_t n, FeatureSet& out) {
+                     e.processBlock(p, n, out);
+                 });
+             }, py::arg("block"),
+             "Feed the next block of a continuous signal, returns the frames it completed")
+        .def("flush", [](Extractor& self) {
+                 FeatureSet out;
+                 self.flush(out);
+                 return feature_dict(out, self.config());
+             }, "End of the block stream: returns the remaining (right-padded) frames and resets")
+        .def("reset", &Extractor::reset, "Drop samples carried between process_block calls")
+        .def("num_frames", &Extractor::numFrames, py::arg("n_samples"))
+        .def_property_readonly("frames_emitted", &Extractor::framesEmitted)
+        .def_property_readonly("n_bins", &Extractor::numBins)
+        .def_property_readonly("sample_rate", [](const Extractor& self) { return self.config().sample_rate; })
+        .def_property_readonly("n_fft", [](const Extractor& self) { return self.config().n_fft; })
+        .def_property_readonly("hop_len", [](const Extractor& self) { return self.config().hop_len; })
+        .def_property_readonly("win_len", [](const Extractor& self) { return self.config().win_len; })
+        .def_property_readonly("center", [](const Extractor& self) { return self.config().center; })
+        .def_property_readonly("window", [](const Extractor& self) {
+            return std::string(window_type_name(self.config().window.type));
+        })
+        .def_property_readonly("pad_mode", [](const Extractor& self) {
+            return std::string(pad_mode_name(self.config().pad_mode));
+        })
+        .def_property_readonly("spectrum", [](const Extractor& self) {
+            return std::string(spectrum_type_name(self.config().spectrum));
+        })
+        .def_property_readonly("n_mel", [](const Extractor& self) { return self.config().n_mel; })
+        .def_property_readonly("n_mfcc", [](const Extractor& self) { return self.config().n_mfcc; })
+        .def_property_readonly("config_hash", [](const Extractor& self) { return config_hash(self.config()); });
+}
@@ -0,0 +1,312 @@
+// On-disk feature cache, see feature_cache.hpp
+
+#include <feature_cache.hpp>
+#include <feature_file.hpp>
+#include <wav_io.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t P1 = 11400714785074694791ull;
+const uint64_t P2 = 14029467366897019727ull;
+const uint64_t P3 = 1609587929392839161ull;
+const uint64_t P4 = 9650029242287828579ull;
+const uint64_t P5 = 2870177450012600261ull;
+
+uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * P2;
+    return rotl(acc, 31) * P1;
+}
+
+uint64_t merge64(uint64_t acc, uint64_t value) {
+    acc ^= round64(0, value);
+    return acc * P1 + P4;
+}
+
+uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+// xxHash64 over bytes (little-endian reads), seeded
+uint64_t hash_bytes(const void* data, size_t len, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+        uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge64(h, v1);
+        h = merge64(h, v2);
+        h = merge64(h, v3);
+        h = merge64(h, v4);
+    } else {
+        h = seed + P5;
+    }
+    h += static_cast<uint64_t>(len);
+    for (; p + 8 <= end; p += 8) h = rotl(h ^ round64(0, read64(p)), 27) * P1 + P4;
+    if (p + 4 <= end) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        h = rotl(h ^ (static_cast<uint64_t>(v) * P1), 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; ++p) h = rotl(h ^ (*p * P5), 11) * P1;
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+void make_dir(const std::string& dir) {
+    if (::mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST)
+        throw std::runtime_error("Cannot create cache directory " + dir + ": " + std::strerror(errno));
+}
+
+bool ends_with(const std::string& s, const char* suffix) {
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+struct Entry {
+    std::string path;
+    uint64_t bytes;
+    int64_t used_ns;  // mtime: last store or hit
+};
+
+int64_t mtime_ns(const struct stat& st) {
+#if defined(__APPLE__)
+    return static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+// every entry under dir; temp files of writers that died more than an hour ago are removed on the way
+std::vector<Entry> scan(const std::string& dir) {
+    std::vector<Entry> entries;
+    const int64_t stale_ns = (static_cast<int64_t>(std::time(nullptr)) - 3600) * 1000000000;
+    DIR* top = ::opendir(dir.c_str());
+    if (!top) return entries;
+    while (dirent* d = ::readdir(top)) {
+        if (d->d_name[0] == '.') continue;
+        const std::string sub = dir + "/" + d->d_name;
+        DIR* inner = ::opendir(sub.c_str());
+        if (!inner) continue;
+        while (dirent* e = ::readdir(inner)) {
+            if (e->d_name[0] == '.') continue;
+            const std::string path = sub + "/" + e->d_name;
+            struct stat st;
+            if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+            if (ends_with(path, ".afeat")) {
+                entries.push_back({path, static_cast<uint64_t>(st.st_size), mtime_ns(st)});
+            } else if (path.find(".afeat.tmp.") != std::string::npos && mtime_ns(st) < stale_ns) {
+                ::unlink(path.c_str());
+            }
+        }
+        ::closedir(inner);
+    }
+    ::closedir(top);
+    return entries;
+}
+
+} // namespace
+
+uint64_t audio_hash(const float* samples, size_t n, int sample_rate) {
+    return hash_bytes(samples, n * sizeof(float), static_cast<uint64_t>(sample_rate));
+}
+
+uint64_t file_identity_hash(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) throw std::runtime_error("Cannot open " + path);
+    const uint64_t fields[4] = {static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino),
+                                static_cast<uint64_t>(st.st_size), static_cast<uint64_t>(mtime_ns(st))};
+    return hash_bytes(path.data(), path.size(), hash_bytes(fields, sizeof(fields), 0));
+}
+
+FeatureCache::FeatureCache(const std::string& dir, const FeatureCacheOptions& options)
+    : dir_(dir), options_(options), bytes_(0), entries_(0), hits_(0), misses_(0), stores_(0), evictions_(0),
+      temp_counter_(0) {
+    if (options_.max_bytes == 0) throw std::invalid_argument("max_bytes must be positive");
+    make_dir(dir_);
+    for (const Entry& e : scan(dir_)) {
+        bytes_ += e.bytes;
+        ++entries_;
+    }
+}
+
+uint64_t FeatureCache::configKey(const ExtractorConfig& config) const {
+    const uint64_t parts[2] = {config_hash(config), options_.float32 ? 1u : 0u};
+    return hash_bytes(parts, sizeof(parts), 0);
+}
+
+std::string FeatureCache::entryPath(uint64_t audio_key, uint64_t config_key) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%016llx.afeat", static_cast<unsigned long long>(audio_key),
+                  static_cast<unsigned long long>(config_key));
+    return dir_ + "/" + std::string(name, 2) + "/" + name;
+}
+
+bool FeatureCache::lookup(uint64_t audio_key, const ExtractorConfig& config, FeatureSet& out) {
+    AF_TRACE_SCOPE("cache_lookup");
+    const std::string path = entryPath(audio_key, configKey(config));
+    try {
+        FeatureFileReader reader(path);
+        // a 64-bit key collision or a foreign file is a miss, not wrong features
+        if (reader.info().config_hash != config_hash(config)) {
+            misses_++;
+            return false;
+        }
+        reader.readFeatures(out);
+    } catch (const std::runtime_error&) {
+        // missing, half-deleted or corrupt entries are all misses
+        misses_++;
+        return false;
+    }
+    ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);  // LRU: now is its last use
+    hits_++;
+    return true;
+}
+
+void FeatureCache::store(uint64_t audio_key, const ExtractorConfig& config, int n_bins, const FeatureSet& features) {
+    AF_TRACE_SCOPE("cache_store");
+    const std::string path = entryPath(audio_key, configKey(config));
+    make_dir(path.substr(0, path.rfind('/')));
+    char suffix[64];
+    std::snprintf(suffix, sizeof(suffix), ".tmp.%ld.%llu", static_cast<long>(::getpid()),
+                  static_cast<unsigned long long>(temp_counter_++));
+    const std::string temp = path + suffix;
+
+    FeatureFileOptions file_options;
+    file_options.float32 = options_.float32;
+    file_options.chunk_frames = std::max(1, features.n_frames);
+    try {
+        FeatureFileWriter writer(temp, config, n_bins, file_options);
+        writer.write(features);
+        writer.close();
+    } catch (...) {
+        ::unlink(temp.c_str());
+        throw;
+    }
+    struct stat st;
+    const uint64_t bytes = ::stat(temp.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+    // atomic on POSIX: readers see the old entry, no entry, or the complete new one
+    if (::rename(temp.c_str(), path.c_str()) != 0) {
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Cannot store cache entry " + path + ": " + std::strerror(errno));
+    }
+    stores_++;
+
+    bool over;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bytes_ += bytes;
+        ++entries_;
+        over = bytes_ > options_.max_bytes || (options_.max_entries && entries_ > options_.max_entries);
+    }
+    if (over) evict();
+}
+
+void FeatureCache::evict() {
+    AF_TRACE_SCOPE("cache_evict");
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Entry> entries = scan(dir_);
+    uint64_t bytes = 0;
+    for (const Entry& e : entries) bytes += e.bytes;
+    size_t count = entries.size();
+
+    const uint64_t byte_target = options_.max_bytes / 10 * 9;
+    const size_t entry_target = options_.max_entries ? std::max<size_t>(1, options_.max_entries / 10 * 9) : 0;
+    const bool over = bytes > options_.max_bytes || (options_.max_entries && count > options_.max_entries);
+    if (over) {
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b) { return a.used_ns < b.used_ns; });
+        for (const Entry& e : entries) {
+            if (bytes <= byte_target && (!entry_target || count <= entry_target)) break;
+            // another process may have evicted it already, either way it is gone
+            if (::unlink(e.path.c_str()) == 0 || errno == ENOENT) {
+                bytes -= e.bytes;
+                --count;
+                evictions_++;
+            }
+        }
+    }
+    bytes_ = bytes;
+    entries_ = count;
+}
+
+void FeatureCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry& e : scan(dir_)) ::unlink(e.path.c_str());
+    bytes_ = 0;
+    entries_ = 0;
+}
+
+FeatureCacheStats FeatureCache::stats() const {
+    FeatureCacheStats s;
+    s.hits = hits_;
+    s.misses = misses_;
+    s.stores = stores_;
+    s.evictions = evictions_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    s.bytes = bytes_;
+    s.entries = entries_;
+    return s;
+}
+
+bool FeatureCache::process(Extractor& extractor, const float* signal, size_t n, FeatureSet& out) {
+    const uint64_t key = audio_hash(signal, n, extractor.config().sample_rate);
+    if (lookup(key, extractor.config(), out)) return true;
+    extractor.process(signal, n, out);
+    store(key, extractor.config(), extractor.numBins(), out);
+    return false;
+}
+
+bool FeatureCache::extractFile(const std::string& path, const ExtractorConfig& config, FeatureSet& out) {
+    ExtractorConfig file_config = config;
+    uint64_t key = 0;
+    if (options_.key == CacheKeyMode::FileIdentity) {
+        // nothing is decoded on a hit, the header gives the sample rate the key needs
+        WavFileInfo info;
+        if (!get_wav_info(path, info)) throw std::runtime_error("Cannot open " + path);
+        file_config.sample_rate = info.sample_rate;
+        key = file_identity_hash(path);
+        if (lookup(key, file_config, out)) return true;
+    }
+    std::pair<std::vector<float>, int> mono = get_wav_mono(path);
+    file_config.sample_rate = mono.second;
+    if (options_.key == CacheKeyMode::Content) {
+        key = audio_hash(mono.first.data(), mono.first.size(), mono.second);
+        if (lookup(key, file_config, out)) return true;
+    }
+    Extractor extractor(file_config);
+    extractor.process(mono.first.data(), mono.first.size(), out);
+    store(key, file_config, extractor.numBins(), out);
+    return false;
+}
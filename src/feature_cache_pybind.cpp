@@ -0,0 +1,77 @@
+// Python bindings for the on-disk feature cache
+// FeatureCache(dir) can also be passed to extract_files(..., cache=...) so a batch reuses earlier results
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <memory>
+#include <string>
+#include <feature_cache.hpp>
+
+namespace py = pybind11;
+
+// extractor_pybind.cpp
+py::dict feature_dict(FeatureSet& out, const ExtractorConfig& config);
+
+namespace {
+
+CacheKeyMode key_mode(const std::string& key) {
+    if (key == "content") return CacheKeyMode::Content;
+    if (key == "file") return CacheKeyMode::FileIdentity;
+    throw py::value_error("key must be 'content' or 'file'");
+}
+
+} // namespace
+
+void bind_feature_cache(py::module_& m) {
+    py::class_<FeatureCache>(m, "FeatureCache",
+        "Content-addressed on-disk feature cache with LRU eviction, safe to share between processes")
+        .def(py::init([](const std::string& dir, uint64_t max_bytes, size_t max_entries, const std::string& key,
+                         bool float32) {
+                 FeatureCacheOptions options;
+                 options.max_bytes = max_bytes;
+                 options.max_entries = max_entries;
+                 options.key = key_mode(key);
+                 options.float32 = float32;
+                 return std::unique_ptr<FeatureCache>(new FeatureCache(dir, options));
+             }),
+             py::arg("dir"), py::arg("max_bytes") = 1ull << 30, py::arg("max_entries") = 0,
+             py::arg("key") = "content", py::arg("float32") = false)
+        .def("extract_file", [](FeatureCache& self, const std::string& path, const Extractor& extractor) {
+                 FeatureSet out;
+                 {
+                     py::gil_scoped_release release;
+                     self.extractFile(path, extractor.config(), out);
+                 }
+                 return feature_dict(out, extractor.config());
+             }, py::arg("path"), py::arg("extractor"),
+             "Features of a WAV file (averaged to mono, at its own sample rate) from the cache or computed and stored")
+        .def("process", [](FeatureCache& self, Extractor& extractor,
+                           const py::array_t<float, py::array::c_style | py::array::forcecast>& signal) {
+                 if (signal.ndim() != 1) throw py::value_error("signal must be one-dimensional");
+                 // under the GIL: the extractor's buffers are shared with every other caller
+                 FeatureSet out;
+                 self.process(extractor, signal.data(), static_cast<size_t>(signal.shape(0)), out);
+                 return feature_dict(out, extractor.config());
+             }, py::arg("extractor"), py::arg("signal"),
+             "Extractor.process(signal) through the cache (the float32 samples are the key)")
+        .def("evict", [](FeatureCache& self) {
+                 py::gil_scoped_release release;
+                 self.evict();
+             }, "Rescan the directory and delete least recently used entries until the limits hold")
+        .def("clear", [](FeatureCache& self) {
+                 py::gil_scoped_release release;
+                 self.clear();
+             }, "Delete every entry")
+        .def("stats", [](const FeatureCache& self) {
+                 FeatureCacheStats s = self.stats();
+                 py::dict d;
+                 d["hits"] = s.hits;
+                 d["misses"] = s.misses;
+                 d["stores"] = s.stores;
+                 d["evictions"] = s.evictions;
+                 d["bytes"] = s.bytes;
+                 d["entries"] = s.entries;
+                 return d;
+             }, "Hits, misses, stores and evictions of this process; bytes and entries of the directory");
+}
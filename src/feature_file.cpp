@@ -0,0 +1,519 @@
+// Columnar binary feature file, see feature_file.hpp
+
+#include <feature_file.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[8] = {'A', 'F', 'E', 'A', 'T', 'S', '0', '1'};
+const uint32_t kVersion = 1;
+const uint64_t kAlign = 64;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t config_hash;
+    int32_t sample_rate;
+    int32_t n_fft;
+    int32_t win_len;
+    int32_t hop_len;
+    int32_t center;
+    uint32_t spectrum;
+    uint32_t features;
+    int32_t n_bins;
+    int32_t n_mfcc;
+    uint32_t n_columns;
+    int32_t chunk_frames;
+    uint32_t reserved0;
+    int64_t n_frames;
+    int64_t n_chunks;
+    uint64_t index_offset;
+    uint64_t index_size;
+    char reserved[24];
+};
+static_assert(sizeof(FileHeader) == 128, "feature file header must stay 128 bytes");
+
+struct ColumnRecord {
+    char name[16];
+    uint32_t feature;
+    uint32_t type;
+    int32_t width;
+    uint32_t reserved;
+};
+static_assert(sizeof(ColumnRecord) == 32, "feature file column record must stay 32 bytes");
+
+uint64_t align_up(uint64_t offset) {
+    return (offset + kAlign - 1) / kAlign * kAlign;
+}
+
+uint64_t data_start(size_t n_columns) {
+    return align_up(sizeof(FileHeader) + n_columns * sizeof(ColumnRecord));
+}
+
+bool is_complex(StoreType type) {
+    return type == StoreType::Complex64 || type == StoreType::Complex128;
+}
+
+size_t row_bytes(const FeatureFileColumn& column) {
+    return static_cast<size_t>(column.width) * store_type_size(column.type);
+}
+
+// the columns a config stores, in FeatureFlags order
+std::vector<FeatureFileColumn> columns_for(const ExtractorConfig& config, int n_bins, bool float32) {
+    const bool complex = config.spectrum == SpectrumType::Complex;
+    const StoreType real = float32 ? StoreType::Float32 : StoreType::Float64;
+    const StoreType spectrum = complex ? (float32 ? StoreType::Complex64 : StoreType::Complex128) : real;
+    const FeatureFileColumn all[] = {
+        {"spectrum", FEATURE_SPECTRUM, spectrum, n_bins},
+        {"centroid", FEATURE_CENTROID, real, 1},
+        {"rolloff", FEATURE_ROLLOFF, real, 1},
+        {"mfcc", FEATURE_MFCC, real, config.n_mfcc},
+        {"rms", FEATURE_RMS, StoreType::Float32, 1},
+        {"zcr", FEATURE_ZCR, StoreType::Float32, 1},
+    };
+    std::vector<FeatureFileColumn> columns;
+    for (const FeatureFileColumn& column : all)
+        if (config.features & column.feature) columns.push_back(column);
+    return columns;
+}
+
+FeatureFileInfo info_from_header(const FileHeader& h) {
+    FeatureFileInfo info;
+    info.config_hash = h.config_hash;
+    info.sample_rate = h.sample_rate;
+    info.n_fft = h.n_fft;
+    info.win_len = h.win_len;
+    info.hop_len = h.hop_len;
+    info.center = h.center != 0;
+    info.spectrum = static_cast<SpectrumType>(h.spectrum);
+    info.features = h.features;
+    info.n_bins = h.n_bins;
+    info.n_mfcc = h.n_mfcc;
+    info.chunk_frames = h.chunk_frames;
+    info.n_frames = h.n_frames;
+    return info;
+}
+
+// rejects anything a reader or an append can't trust, before offsets are used
+void check_header(const FileHeader& h, uint64_t file_size, const std::string& path) {
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) throw std::runtime_error(path + " is not a feature file");
+    if (h.version != kVersion || h.header_size != sizeof(FileHeader))
+        throw std::runtime_error(path + ": unsupported feature file version");
+    if (h.n_columns == 0 || h.n_columns > 6 || h.n_frames < 0 || h.n_chunks < 0 || h.spectrum > 3 ||
+        h.index_size != static_cast<uint64_t>(h.n_chunks) * (2 + h.n_columns) * sizeof(uint64_t) ||
+        (h.index_size > 0 && (h.index_offset > file_size || h.index_size > file_size - h.index_offset)) ||
+        sizeof(FileHeader) + h.n_columns * sizeof(ColumnRecord) > file_size)
+        throw std::runtime_error("Corrupt feature file " + path);
+}
+
+FeatureFileColumn column_from_record(const ColumnRecord& r, const std::string& path) {
+    if (r.type > 3 || r.width < 1 || std::memchr(r.name, 0, sizeof(r.name)) == nullptr)
+        throw std::runtime_error("Corrupt feature file " + path);
+    return FeatureFileColumn{r.name, r.feature, static_cast<StoreType>(r.type), r.width};
+}
+
+// appends n rows of one feature to a chunk buffer, converting to the stored type
+template <typename T>
+void append_rows(std::vector<char>& buffer, const T* src, size_t values, StoreType type) {
+    const size_t at = buffer.size();
+    if (type == StoreType::Float32 || type == StoreType::Complex64) {
+        buffer.resize(at + values * sizeof(float));
+        float* dst = reinterpret_cast<float*>(buffer.data() + at);
+        for (size_t i = 0; i < values; ++i) dst[i] = static_cast<float>(src[i]);
+    } else {
+        buffer.resize(at + values * sizeof(double));
+        double* dst = reinterpret_cast<double*>(buffer.data() + at);
+        for (size_t i = 0; i < values; ++i) dst[i] = static_cast<double>(src[i]);
+    }
+}
+
+} // namespace
+
+const char* store_type_descr(StoreType type) {
+    switch (type) {
+        case StoreType::Float32: return "<f4";
+        case StoreType::Float64: return "<f8";
+        case StoreType::Complex64: return "<c8";
+        case StoreType::Complex128: return "<c16";
+    }
+    return "";
+}
+
+size_t store_type_size(StoreType type) {
+    switch (type) {
+        case StoreType::Float32: return 4;
+        case StoreType::Float64: return 8;
+        case StoreType::Complex64: return 8;
+        case StoreType::Complex128: return 16;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------- FeatureFileWriter
+
+FeatureFileWriter::FeatureFileWriter(const std::string& path, const ExtractorConfig& config, int n_bins,
+                                     const FeatureFileOptions& options)
+    : path_(path), file_(nullptr), end_(0), pending_frames_(0) {
+    if (options.chunk_frames < 1) throw std::invalid_argument("chunk_frames must be positive");
+    const Extractor probe(config);  // validated config (win_len filled in), throws on a bad one
+    const ExtractorConfig& c = probe.config();
+
+    info_.config_hash = config_hash(c);
+    info_.sample_rate = c.sample_rate;
+    info_.n_fft = c.n_fft;
+    info_.win_len = c.win_len;
+    info_.hop_len = c.hop_len;
+    info_.center = c.center;
+    info_.spectrum = c.spectrum;
+    info_.features = c.features;
+    info_.n_bins = n_bins;
+    info_.n_mfcc = c.n_mfcc;
+    info_.chunk_frames = options.chunk_frames;
+    info_.columns = columns_for(c, n_bins, options.float32);
+
+    if (options.append) file_ = std::fopen(path.c_str(), "r+b");
+    if (file_) {
+        // existing file: it keeps its own storage types and chunk size, the config must match
+        FileHeader h;
+        std::fseek(file_, 0, SEEK_END);
+        const long size = std::ftell(file_);
+        std::fseek(file_, 0, SEEK_SET);
+        if (size < static_cast<long>(sizeof(h)) || std::fread(&h, sizeof(h), 1, file_) != 1) {
+            std::fclose(file_);
+            throw std::runtime_error(path + " is not a feature file");
+        }
+        try {
+            check_header(h, static_cast<uint64_t>(size), path);
+            if (h.config_hash != info_.config_hash || h.n_bins != n_bins)
+                throw std::invalid_argument(path + " was written with another extractor config");
+            std::vector<ColumnRecord> records(h.n_columns);
+            std::vector<uint64_t> index(h.index_size / sizeof(uint64_t));
+            if (std::fread(records.data(), sizeof(ColumnRecord), records.size(), file_) != records.size() ||
+                std::fseek(file_, static_cast<long>(h.index_offset), SEEK_SET) != 0 ||
+                std::fread(index.data(), 1, h.index_size, file_) != h.index_size)
+                throw std::runtime_error("Cannot read " + path);
+            info_ = info_from_header(h);
+            for (const ColumnRecord& r : records) info_.columns.push_back(column_from_record(r, path));
+            const size_t stride = 2 + h.n_columns;
+            for (int64_t k = 0; k < h.n_chunks; ++k) {
+                const uint64_t* e = &index[k * stride];
+                chunks_.push_back({static_cast<int64_t>(e[0]), static_cast<int64_t>(e[1]),
+                                   std::vector<uint64_t>(e + 2, e + stride)});
+            }
+        } catch (...) {
+            std::fclose(file_);
+            throw;
+        }
+        // new chunks go after the current index, which stays valid until the header points elsewhere
+        end_ = static_cast<uint64_t>(size);
+    } else {
+        file_ = std::fopen(path.c_str(), "w+b");
+        if (!file_) throw std::runtime_error("Cannot create " + path);
+        std::vector<ColumnRecord> records;
+        for (const FeatureFileColumn& column : info_.columns) {
+            ColumnRecord r = {};
+            std::strncpy(r.name, column.name.c_str(), sizeof(r.name) - 1);
+            r.feature = column.feature;
+            r.type = static_cast<uint32_t>(column.type);
+            r.width = column.width;
+            records.push_back(r);
+        }
+        try {
+            writeAt(sizeof(FileHeader), records.data(), records.size() * sizeof(ColumnRecord));
+        } catch (...) {
+            std::fclose(file_);
+            throw;
+        }
+        end_ = data_start(records.size());
+        // header is written by close(); until then the file has no valid magic
+    }
+
+    pending_.resize(info_.columns.size());
+    for (size_t i = 0; i < info_.columns.size(); ++i)
+        pending_[i].reserve(static_cast<size_t>(info_.chunk_frames) * row_bytes(info_.columns[i]));
+}
+
+FeatureFileWriter::~FeatureFileWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void FeatureFileWriter::writeAt(uint64_t offset, const void* data, size_t bytes) {
+    if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0 ||
+        (bytes && std::fwrite(data, 1, bytes, file_) != bytes))
+        throw std::runtime_error("Cannot write " + path_);
+}
+
+void FeatureFileWriter::write(const FeatureSet& frames) {
+    if (!file_) throw std::runtime_error("Feature file " + path_ + " is closed");
+    const size_t n = static_cast<size_t>(frames.n_frames);
+    // every stored column has to be there, with the stored width
+    for (const FeatureFileColumn& column : info_.columns) {
+        size_t values = n * column.width * (is_complex(column.type) ? 2 : 1);
+        size_t have = 0;
+        switch (column.feature) {
+            case FEATURE_SPECTRUM: have = frames.spectrum.size(); break;
+            case FEATURE_CENTROID: have = frames.centroid.size(); break;
+            case FEATURE_ROLLOFF: have = frames.rolloff.size(); break;
+            case FEATURE_MFCC: have = frames.mfcc.size(); break;
+            case FEATURE_RMS: have = frames.rms.size(); break;
+            case FEATURE_ZCR: have = frames.zcr.size(); break;
+        }
+        if (have != values) throw std::invalid_argument("frames don't match the feature file's columns: " + column.name);
+    }
+
+    size_t row = 0;
+    while (row < n) {
+        const size_t take = std::min(n - row, static_cast<size_t>(info_.chunk_frames - pending_frames_));
+        for (size_t i = 0; i < info_.columns.size(); ++i) {
+            const FeatureFileColumn& column = info_.columns[i];
+            const size_t per_row = column.width * (is_complex(column.type) ? 2 : 1);
+            const size_t at = row * per_row;
+            const size_t values = take * per_row;
+            switch (column.feature) {
+                case FEATURE_SPECTRUM: append_rows(pending_[i], frames.spectrum.data() + at, values, column.type); break;
+                case FEATURE_CENTROID: append_rows(pending_[i], frames.centroid.data() + at, values, column.type); break;
+                case FEATURE_ROLLOFF: append_rows(pending_[i], frames.rolloff.data() + at, values, column.type); break;
+                case FEATURE_MFCC: append_rows(pending_[i], frames.mfcc.data() + at, values, column.type); break;
+                case FEATURE_RMS: append_rows(pending_[i], frames.rms.data() + at, values, column.type); break;
+                case FEATURE_ZCR: append_rows(pending_[i], frames.zcr.data() + at, values, column.type); break;
+            }
+        }
+        pending_frames_ += static_cast<int64_t>(take);
+        row += take;
+        if (pending_frames_ == info_.chunk_frames) flushChunk();
+    }
+}
+
+void FeatureFileWriter::flushChunk() {
+    if (pending_frames_ == 0) return;
+    Chunk chunk = {info_.n_frames, pending_frames_, {}};
+    for (std::vector<char>& rows : pending_) {
+        const uint64_t offset = align_up(end_);
+        writeAt(offset, rows.data(), rows.size());
+        chunk.offsets.push_back(offset);
+        end_ = offset + rows.size();
+        rows.clear();
+    }
+    chunks_.push_back(chunk);
+    info_.n_frames += pending_frames_;
+    pending_frames_ = 0;
+}
+
+void FeatureFileWriter::close() {
+    if (!file_) return;
+    std::FILE* file = file_;
+    try {
+        flushChunk();
+
+        std::vector<uint64_t> index;
+        for (const Chunk& chunk : chunks_) {
+            index.push_back(static_cast<uint64_t>(chunk.first));
+            index.push_back(static_cast<uint64_t>(chunk.n));
+            index.insert(index.end(), chunk.offsets.begin(), chunk.offsets.end());
+        }
+        FileHeader h = {};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.header_size = sizeof(FileHeader);
+        h.config_hash = info_.config_hash;
+        h.sample_rate = info_.sample_rate;
+        h.n_fft = info_.n_fft;
+        h.win_len = info_.win_len;
+        h.hop_len = info_.hop_len;
+        h.center = info_.center ? 1 : 0;
+        h.spectrum = static_cast<uint32_t>(info_.spectrum);
+        h.features = info_.features;
+        h.n_bins = info_.n_bins;
+        h.n_mfcc = info_.n_mfcc;
+        h.n_columns = static_cast<uint32_t>(info_.columns.size());
+        h.chunk_frames = info_.chunk_frames;
+        h.n_frames = info_.n_frames;
+        h.n_chunks = static_cast<int64_t>(chunks_.size());
+        h.index_offset = align_up(end_);
+        h.index_size = index.size() * sizeof(uint64_t);
+
+        // index first, header last: until the header is rewritten the old index is still the valid one
+        writeAt(h.index_offset, index.data(), h.index_size);
+        end_ = h.index_offset + h.index_size;
+        if (std::fflush(file_) != 0) throw std::runtime_error("Cannot write " + path_);
+        writeAt(0, &h, sizeof(h));
+    } catch (...) {
+        file_ = nullptr;
+        std::fclose(file);
+        throw;
+    }
+    file_ = nullptr;
+    if (std::fclose(file) != 0) throw std::runtime_error("Cannot write " + path_);
+}
+
+// ---------------------------------------------------------------- FeatureFileReader
+
+FeatureFileReader::FeatureFileReader(const std::string& path) : data_(nullptr), size_(0) {
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open " + path);
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot open " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);  // the mapping keeps the file
+#endif
+
+    try {
+        if (size_ < sizeof(FileHeader)) throw std::runtime_error(path + " is not a feature file");
+        FileHeader h;
+        std::memcpy(&h, data_, sizeof(h));
+        check_header(h, size_, path);
+        info_ = info_from_header(h);
+        for (uint32_t c = 0; c < h.n_columns; ++c) {
+            ColumnRecord r;
+            std::memcpy(&r, data_ + sizeof(FileHeader) + c * sizeof(ColumnRecord), sizeof(r));
+            info_.columns.push_back(column_from_record(r, path));
+        }
+
+        const size_t stride = 2 + h.n_columns;
+        const char* index = data_ + h.index_offset;
+        int64_t expect = 0;
+        for (int64_t k = 0; k < h.n_chunks; ++k) {
+            std::vector<uint64_t> e(stride);
+            std::memcpy(e.data(), index + k * stride * sizeof(uint64_t), stride * sizeof(uint64_t));
+            const int64_t first = static_cast<int64_t>(e[0]);
+            const int64_t n = static_cast<int64_t>(e[1]);
+            if (first != expect || n <= 0) throw std::runtime_error("Corrupt feature file " + path);
+            std::vector<uint64_t> offsets(e.begin() + 2, e.end());
+            for (uint32_t c = 0; c < h.n_columns; ++c) {
+                const uint64_t bytes = static_cast<uint64_t>(n) * row_bytes(info_.columns[c]);
+                if (offsets[c] > size_ || bytes > size_ - offsets[c]) throw std::runtime_error("Corrupt feature file " + path);
+            }
+            first_.push_back(first);
+            count_.push_back(n);
+            offsets_.push_back(offsets);
+            expect += n;
+        }
+        if (expect != info_.n_frames) throw std::runtime_error("Corrupt feature file " + path);
+    } catch (...) {
+#if !defined(_WIN32)
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        throw;
+    }
+}
+
+FeatureFileReader::~FeatureFileReader() {
+#if !defined(_WIN32)
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+int FeatureFileReader::column(const std::string& name) const {
+    for (size_t i = 0; i < info_.columns.size(); ++i)
+        if (info_.columns[i].name == name) return static_cast<int>(i);
+    return -1;
+}
+
+size_t FeatureFileReader::chunkOf(int64_t frame) const {
+    return static_cast<size_t>(std::upper_bound(first_.begin(), first_.end(), frame) - first_.begin()) - 1;
+}
+
+const char* FeatureFileReader::block(size_t chunk, int column) const {
+    return data_ + offsets_[chunk][column];
+}
+
+void FeatureFileReader::checkRange(int column, int64_t start, int64_t stop) const {
+    if (column < 0 || column >= static_cast<int>(info_.columns.size()))
+        throw std::invalid_argument("No such column in the feature file");
+    if (start < 0 || stop < start || stop > info_.n_frames)
+        throw std::invalid_argument("frame range outside the feature file");
+}
+
+const void* FeatureFileReader::view(int column, int64_t start, int64_t stop) const {
+    checkRange(column, start, stop);
+    if (start == stop) return data_;
+    const size_t k = chunkOf(start);
+    if (stop > first_[k] + count_[k]) return nullptr;
+    return block(k, column) + (start - first_[k]) * row_bytes(info_.columns[column]);
+}
+
+void FeatureFileReader::read(int column, int64_t start, int64_t stop, void* out) const {
+    checkRange(column, start, stop);
+    const size_t row = row_bytes(info_.columns[column]);
+    char* dst = static_cast<char*>(out);
+    while (start < stop) {
+        const size_t k = chunkOf(start);
+        const int64_t end = std::min(stop, first_[k] + count_[k]);
+        const size_t bytes = static_cast<size_t>(end - start) * row;
+        std::memcpy(dst, block(k, column) + (start - first_[k]) * row, bytes);
+        dst += bytes;
+        start = end;
+    }
+}
+
+void FeatureFileReader::readFeatures(FeatureSet& out) const {
+    out = FeatureSet();
+    out.n_frames = static_cast<int>(info_.n_frames);
+    out.n_bins = info_.features & FEATURE_SPECTRUM ? info_.n_bins : 0;
+    out.n_mfcc = info_.features & FEATURE_MFCC ? info_.n_mfcc : 0;
+    for (size_t c = 0; c < info_.columns.size(); ++c) {
+        const FeatureFileColumn& column = info_.columns[c];
+        const size_t values = static_cast<size_t>(info_.n_frames) * column.width * (is_complex(column.type) ? 2 : 1);
+        const bool narrow = column.type == StoreType::Float32 || column.type == StoreType::Complex64;
+        if (column.feature == FEATURE_RMS || column.feature == FEATURE_ZCR) {
+            std::vector<float>& dst = column.feature == FEATURE_RMS ? out.rms : out.zcr;
+            dst.resize(values);
+            read(static_cast<int>(c), 0, info_.n_frames, dst.data());
+            continue;
+        }
+        std::vector<double>* dst = nullptr;
+        switch (column.feature) {
+            case FEATURE_SPECTRUM: dst = &out.spectrum; break;
+            case FEATURE_CENTROID: dst = &out.centroid; break;
+            case FEATURE_ROLLOFF: dst = &out.rolloff; break;
+            case FEATURE_MFCC: dst = &out.mfcc; break;
+            default: continue;
+        }
+        dst->resize(values);
+        if (!narrow) {
+            read(static_cast<int>(c), 0, info_.n_frames, dst->data());
+            continue;
+        }
+        std::vector<float> floats(values);
+        read(static_cast<int>(c), 0, info_.n_frames, floats.data());
+        std::copy(floats.begin(), floats.end(), dst->begin());
+    }
+}
+
+std::vector<int64_t> FeatureFileReader::chunkBoundaries() const {
+    std::vector<int64_t> bounds(first_);
+    bounds.push_back(info_.n_frames);
+    return bounds;
+}
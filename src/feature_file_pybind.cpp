@@ -0,0 +1,175 @@
+// Python bindings for the columnar feature file
+// FeatureFile.read() returns read-only NumPy views into the mapping when the frames lie in one chunk
+// (the array keeps the mapping alive), and a copy of just those frames otherwise
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <pybind11/complex.h>
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <feature_file.hpp>
+#include <file_pipeline.hpp>
+#include <wav_io.hpp>
+
+namespace py = pybind11;
+
+namespace {
+
+py::dtype store_dtype(StoreType type) {
+    switch (type) {
+        case StoreType::Float32: return py::dtype::of<float>();
+        case StoreType::Float64: return py::dtype::of<double>();
+        case StoreType::Complex64: return py::dtype::of<std::complex<float>>();
+        case StoreType::Complex128: return py::dtype::of<std::complex<double>>();
+    }
+    throw std::invalid_argument("Unknown feature file dtype");
+}
+
+template <typename Elem, typename T>
+size_t copy_column(py::dict features, const char* name, std::vector<T>& out) {
+    using Array = py::array_t<Elem, py::array::c_style | py::array::forcecast>;
+    if (!features.contains(name)) throw py::value_error(std::string("features has no '") + name + "' array");
+    Array a = features[name].template cast<Array>();
+    const T* p = reinterpret_cast<const T*>(a.data());
+    out.assign(p, p + static_cast<size_t>(a.size()) * (sizeof(Elem) / sizeof(T)));
+    return a.ndim() > 0 ? static_cast<size_t>(a.shape(0)) : 0;
+}
+
+// an Extractor.process() dict (or any dict with the same arrays) as a FeatureSet for the writer
+FeatureSet to_feature_set(py::dict features, const FeatureFileInfo& info) {
+    FeatureSet out;
+    out.n_bins = info.n_bins;
+    out.n_mfcc = info.n_mfcc;
+    size_t frames = 0;
+    const unsigned f = info.features;
+    if (f & FEATURE_SPECTRUM) {
+        frames = info.spectrum == SpectrumType::Complex ? copy_column<std::complex<double>>(features, "spectrum", out.spectrum)
+                                                        : copy_column<double>(features, "spectrum", out.spectrum);
+    }
+    if (f & FEATURE_CENTROID) frames = copy_column<double>(features, "centroid", out.centroid);
+    if (f & FEATURE_ROLLOFF) frames = copy_column<double>(features, "rolloff", out.rolloff);
+    if (f & FEATURE_MFCC) frames = copy_column<double>(features, "mfcc", out.mfcc);
+    if (f & FEATURE_RMS) frames = copy_column<float>(features, "rms", out.rms);
+    if (f & FEATURE_ZCR) frames = copy_column<float>(features, "zcr", out.zcr);
+    out.n_frames = static_cast<int>(frames);
+    return out;  // the writer checks every column against n_frames
+}
+
+FeatureFileOptions make_options(int chunk_frames, bool float32, bool append) {
+    FeatureFileOptions options;
+    options.chunk_frames = chunk_frames;
+    options.float32 = float32;
+    options.append = append;
+    return options;
+}
+
+py::array read_column(const std::shared_ptr<FeatureFileReader>& self, const std::string& name, int64_t start,
+                      py::object stop_arg) {
+    const int c = self->column(name);
+    if (c < 0) throw py::value_error("Feature file has no column '" + name + "'");
+    const int64_t n = self->numFrames();
+    int64_t stop = stop_arg.is_none() ? n : stop_arg.cast<int64_t>();
+    // Python slice semantics for negative and out-of-range bounds
+    if (start < 0) start += n;
+    if (stop < 0) stop += n;
+    start = std::max<int64_t>(0, std::min(start, n));
+    stop = std::max(start, std::min(stop, n));
+
+    const FeatureFileColumn& column = self->info().columns[c];
+    std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(stop - start)};
+    if (column.width > 1) shape.push_back(column.width);
+
+    if (const void* p = self->view(c, start, stop)) {
+        // the capsule holds a reference to the reader, so the mapping outlives every view
+        py::capsule keep(new std::shared_ptr<FeatureFileReader>(self),
+                         [](void* p) { delete static_cast<std::shared_ptr<FeatureFileReader>*>(p); });
+        py::array view(store_dtype(column.type), shape, p, keep);
+        view.attr("setflags")(py::arg("write") = false);
+        return view;
+    }
+    py::array copy(store_dtype(column.type), shape);
+    {
+        py::gil_scoped_release release;
+        self->read(c, start, stop, copy.mutable_data());
+    }
+    return copy;
+}
+
+} // namespace
+
+void bind_feature_file(py::module_& m) {
+    py::class_<FeatureFileWriter>(m, "FeatureFileWriter",
+        "Writes Extractor results to a columnar feature file (chunked, appendable, memory-mappable)")
+        .def(py::init([](const std::string& path, const Extractor& extractor, int chunk_frames, bool float32,
+                         bool append) {
+                 return std::unique_ptr<FeatureFileWriter>(new FeatureFileWriter(
+                     path, extractor.config(), extractor.numBins(), make_options(chunk_frames, float32, append)));
+             }),
+             py::arg("path"), py::arg("extractor"), py::arg("chunk_frames") = 4096, py::arg("float32") = false,
+             py::arg("append") = false)
+        .def("write", [](FeatureFileWriter& self, const py::dict& features) {
+                 // under the GIL: the pending chunk and the frame index are shared by every Python thread
+                 FeatureSet frames = to_feature_set(features, self.info());
+                 self.write(frames);
+             }, py::arg("features"), "Append the frames of an Extractor.process() / process_block() result")
+        .def("close", &FeatureFileWriter::close, "Write the remaining frames, the frame index and the header")
+        .def("__enter__", [](FeatureFileWriter& self) -> FeatureFileWriter& { return self; })
+        .def("__exit__", [](FeatureFileWriter& self, py::object, py::object, py::object) { self.close(); })
+        .def_property_readonly("n_frames", &FeatureFileWriter::numFrames);
+
+    py::class_<FeatureFileReader, std::shared_ptr<FeatureFileReader>>(m, "FeatureFile",
+        "Memory-mapped feature file: only the frames that are read are touched")
+        .def(py::init([](const std::string& path) { return std::make_shared<FeatureFileReader>(path); }),
+             py::arg("path"))
+        .def("read", &read_column, py::arg("name"), py::arg("start") = 0, py::arg("stop") = py::none(),
+             "Frames [start, stop) of a feature: a read-only view when they lie in one chunk, else a copy")
+        .def("__len__", &FeatureFileReader::numFrames)
+        .def("matches", [](const FeatureFileReader& self, const Extractor& extractor) {
+                 return self.info().config_hash == config_hash(extractor.config());
+             }, py::arg("extractor"), "True when the file was written with this extractor's settings")
+        .def_property_readonly("n_frames", &FeatureFileReader::numFrames)
+        .def_property_readonly("columns", [](const FeatureFileReader& self) {
+            std::vector<std::string> names;
+            for (const FeatureFileColumn& column : self.info().columns) names.push_back(column.name);
+            return names;
+        })
+        .def_property_readonly("chunk_boundaries", &FeatureFileReader::chunkBoundaries)
+        .def_property_readonly("config_hash", [](const FeatureFileReader& self) { return self.info().config_hash; })
+        .def_property_readonly("sample_rate", [](const FeatureFileReader& self) { return self.info().sample_rate; })
+        .def_property_readonly("n_fft", [](const FeatureFileReader& self) { return self.info().n_fft; })
+        .def_property_readonly("win_len", [](const FeatureFileReader& self) { return self.info().win_len; })
+        .def_property_readonly("hop_len", [](const FeatureFileReader& self) { return self.info().hop_len; })
+        .def_property_readonly("center", [](const FeatureFileReader& self) { return self.info().center; })
+        .def_property_readonly("spectrum", [](const FeatureFileReader& self) {
+            return std::string(spectrum_type_name(self.info().spectrum));
+        });
+
+    m.def("extract_file_to_feature_file", [](const std::string& path, const std::string& out_path,
+                                             const Extractor& extractor, bool append, int chunk_frames, bool float32,
+                                             int segment_frames, int n_workers) {
+              PipelineOptions options;
+              options.segment_frames = segment_frames;
+              options.n_workers = n_workers;
+              py::gil_scoped_release release;
+              // the pipeline runs at the file's sample rate, which is part of the stored config hash
+              WavFileInfo info;
+              if (!get_wav_info(path, info)) throw std::runtime_error("Cannot open " + path);
+              ExtractorConfig config = extractor.config();
+              config.sample_rate = info.sample_rate;
+              FeatureFileWriter writer(out_path, config, extractor.numBins(),
+                                       make_options(chunk_frames, float32, append));
+              extract_file_pipelined(path, config, options, [&writer](const FeatureSet& rows, int64_t) {
+                  writer.write(rows);
+              });
+              writer.close();
+              return writer.numFrames();
+          },
+          py::arg("path"), py::arg("out_path"), py::arg("extractor"), py::arg("append") = false,
+          py::arg("chunk_frames") = 4096, py::arg("float32") = false, py::arg("segment_frames") = 1024,
+          py::arg("n_workers") = 2,
+          "Run one (long) file through the decode/compute/write pipeline into a feature file, returns its frame count");
+}
@@ -7,6 +7,58 @@
 #include <algorithm>
 #include <numeric>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <fft_stft.hpp>
+#include <trace.hpp>
+
+std::mutex& fftw_planner_mutex() {
+    static std::mutex planner_mutex;
+    return planner_mutex;
+}
+
+// Cached FFT plan
+FftPlan::FftPlan(int n) : n_(n) {
+    in_ = (double*) fftw_malloc(sizeof(double) * n_);
+    out_ = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (n_ / 2 + 1));
+    std::fill(in_, in_ + n_, 0.0);
+
+    std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+    plan_ = fftw_plan_dft_r2c_1d(n_, in_, out_, FFTW_ESTIMATE);
+}
+
+FftPlan::~FftPlan() {
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+        fftw_destroy_plan(plan_);
+    }
+    fftw_free(in_);
+    fftw_free(out_);
+}
+
+InverseFftPlan::InverseFftPlan(int n) : n_(n) {
+    in_ = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (n_ / 2 + 1));
+    out_ = (double*) fftw_malloc(sizeof(double) * n_);
+    std::fill(out_, out_ + n_, 0.0);
+
+    std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+    plan_ = fftw_plan_dft_c2r_1d(n_, in_, out_, FFTW_ESTIMATE);
+}
+
+InverseFftPlan::~InverseFftPlan() {
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+        fftw_destroy_plan(plan_);
+    }
+    fftw_free(in_);
+    fftw_free(out_);
+}
+
+// Hann window
+std::vector<double> hann_window(int win_len) {
+    return window_samples(WindowSpec(), win_len);
+}
 
 // FFT
 std::vector<std::complex<double>> compute_fft(const std::vector<double>& input) {
@@ -16,95 +68,381 @@ std::vector<std::complex<double>> compute_fft(const std::vector<double>& input)
 
     std::copy(input.begin(), input.end(), in);
 
-    fftw_plan plan = fftw_plan_dft_r2c_1d(N, in, out, FFTW_ESTIMATE);
+    fftw_plan plan;
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+        plan = fftw_plan_dft_r2c_1d(N, in, out, FFTW_ESTIMATE);
+    }
     fftw_execute(plan);
 
     std::vector<std::complex<double>> result(N / 2 + 1);
     for (int i = 0; i < N / 2 + 1; ++i)
         result[i] = std::complex<double>(out[i][0], out[i][1]);
 
-    fftw_destroy_plan(plan);
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+        fftw_destroy_plan(plan);
+    }
     fftw_free(in);
     fftw_free(out);
 
     return result;
 }
 
+// Framing / padding
+
+PadMode parse_pad_mode(const std::string& name) {
+    if (name == "constant") return PadMode::Constant;
+    if (name == "reflect") return PadMode::Reflect;
+    if (name == "edge") return PadMode::Edge;
+    throw std::invalid_argument("Unknown pad mode: " + name);
+}
+
+const char* pad_mode_name(PadMode mode) {
+    switch (mode) {
+        case PadMode::Reflect: return "reflect";
+        case PadMode::Edge: return "edge";
+        default: return "constant";
+    }
+}
+
+SpectrumType parse_spectrum_type(const std::string& name) {
+    if (name == "complex") return SpectrumType::Complex;
+    if (name == "magnitude") return SpectrumType::Magnitude;
+    if (name == "power") return SpectrumType::Power;
+    if (name == "log_power") return SpectrumType::LogPower;
+    throw std::invalid_argument("Unknown spectrum type: " + name);
+}
+
+const char* spectrum_type_name(SpectrumType type) {
+    switch (type) {
+        case SpectrumType::Complex: return "complex";
+        case SpectrumType::Power: return "power";
+        case SpectrumType::LogPower: return "log_power";
+        default: return "magnitude";
+    }
+}
+
+long pad_index(long i, size_t n, PadMode mode) {
+    const long last = static_cast<long>(n) - 1;
+    if (n == 0 || mode == PadMode::Constant) return -1;
+    if (mode == PadMode::Edge || last == 0) return i < 0 ? 0 : last;
+    // reflect without repeating the edge sample, folded for pads longer than the signal
+    long period = 2 * last;
+    long j = i % period;
+    if (j < 0) j += period;
+    return j <= last ? j : period - j;
+}
+
+int Framing::numFrames(size_t n) const {
+    long padded = static_cast<long>(n) + 2 * padding();
+    if (n == 0 || padded < n_fft) return 0;
+    return static_cast<int>((padded - n_fft) / hop_len + 1);
+}
+
+// Caller-buffer versions and the kernels behind every STFT / MFCC entry point
+
+namespace {
+
+// n_fft with 0 standing for win_len; every STFT entry point rejects unusable settings here
+int checked_fft_size(int win_len, int hop_len, int n_fft) {
+    if (n_fft <= 0) n_fft = win_len;
+    if (win_len <= 0 || hop_len <= 0 || n_fft < win_len)
+        throw std::invalid_argument("need win_len > 0, hop_len > 0 and n_fft >= win_len");
+    return n_fft;
+}
+
+// the kernels of this thread's last call, rebuilt only when the settings change
+SpectrumProcessor& thread_spectrum(int win_len, int n_fft, const WindowSpec& window) {
+    thread_local std::unique_ptr<SpectrumProcessor> cached;
+    thread_local WindowSpec cached_window;
+    if (!cached || cached->winLen() != win_len || cached->fftSize() != n_fft ||
+        cached_window.type != window.type || cached_window.periodic != window.periodic ||
+        cached_window.beta != window.beta) {
+        cached.reset(new SpectrumProcessor(win_len, n_fft, window));
+        cached_window = window;
+    }
+    return *cached;
+}
+
+MfccProcessor& thread_mfcc(int sample_rate, int fft_size, int n_mel, int n_mfcc, SpectrumType input) {
+    thread_local std::unique_ptr<MfccProcessor> cached;
+    thread_local int cached_rate = 0;
+    thread_local int cached_fft = 0;
+    if (!cached || cached_rate != sample_rate || cached_fft != fft_size || cached->numMel() != n_mel ||
+        cached->numMfcc() != n_mfcc || cached->input() != input) {
+        cached.reset(new MfccProcessor(sample_rate, fft_size, n_mel, n_mfcc, input));
+        cached_rate = sample_rate;
+        cached_fft = fft_size;
+    }
+    return *cached;
+}
+
+// thread scratch that only ever grows, so steady-state calls don't allocate
+template <typename T>
+T* thread_buffer(std::vector<T>& buffer, size_t n) {
+    if (buffer.size() < n) buffer.resize(n);
+    return buffer.data();
+}
+
+// Frequency-major results are staged kBlockFrames frames at a time (time-major, small enough to stay in
+// L1/L2) and transposed out block by block: each destination row then gets kBlockFrames consecutive values
+// per block, whole cache lines, instead of one strided value per frame
+const int kBlockFrames = 16;
+
+// block [count][width * elem] -> rows[k][(first + i) * elem ...], elem = 2 for interleaved complex values
+void scatter_block(const double* block, int count, int width, int elem, double* const* rows, int first) {
+    AF_TRACE_SCOPE("transpose");
+    const int row = width * elem;
+    for (int k = 0; k < width; ++k) {
+        double* dst = rows[k] + static_cast<size_t>(first) * elem;
+        const double* src = block + k * elem;
+        for (int i = 0; i < count; ++i)
+            for (int e = 0; e < elem; ++e) dst[i * elem + e] = src[i * row + e];
+    }
+}
+
+// the inverse: frames [first, first + count) of frequency-major rows into a time-major block
+void gather_block(const double* const* rows, int first, int count, int width, int elem, double* block) {
+    AF_TRACE_SCOPE("transpose");
+    const int row = width * elem;
+    for (int k = 0; k < width; ++k) {
+        const double* src = rows[k] + static_cast<size_t>(first) * elem;
+        double* dst = block + k * elem;
+        for (int i = 0; i < count; ++i)
+            for (int e = 0; e < elem; ++e) dst[i * row + e] = src[i * elem + e];
+    }
+}
+
+template <typename T>
+void stft_kernel(const T* signal, size_t n, int win_len, int hop_len, int n_fft, bool center, PadMode pad_mode,
+                 const WindowSpec& window, SpectrumType type, Layout layout, double* const* rows) {
+    AF_TRACE_SCOPE("compute_stft");
+    const int num_frames = stft_num_frames(n, win_len, hop_len, n_fft, center);
+    if (num_frames == 0) return;
+    if (n_fft <= 0) n_fft = win_len;
+
+    Framing framing = {n_fft, hop_len, center, pad_mode};
+    SpectrumProcessor& spectrum = thread_spectrum(win_len, n_fft, window);
+    thread_local std::vector<T> scratch_storage;  // edge frames when centered
+    T* scratch = thread_buffer(scratch_storage, n_fft);
+
+    if (layout == Layout::TimeMajor) {
+        for (int frame = 0; frame < num_frames; ++frame)
+            spectrum.compute(frame_at(signal, n, framing, frame, scratch), type, rows[frame]);
+        return;
+    }
+    const int bins = spectrum.bins();
+    const int elem = spectrum_values(type, 1);
+    thread_local std::vector<double> block_storage;
+    double* block = thread_buffer(block_storage, static_cast<size_t>(kBlockFrames) * bins * elem);
+    for (int first = 0; first < num_frames; first += kBlockFrames) {
+        const int count = std::min(kBlockFrames, num_frames - first);
+        for (int i = 0; i < count; ++i)
+            spectrum.compute(frame_at(signal, n, framing, first + i, scratch), type,
+                             block + static_cast<size_t>(i) * bins * elem);
+        scatter_block(block, count, bins, elem, rows, first);
+    }
+}
+
+void mfcc_kernel(const double* const* spectrogram, int n_frames, int sample_rate, int fft_size, int n_mel,
+                 int n_mfcc, SpectrumType type, Layout layout, double* const* rows) {
+    AF_TRACE_SCOPE("compute_mfcc");
+    if (n_frames <= 0) return;
+    MfccProcessor& mfcc = thread_mfcc(sample_rate, fft_size, n_mel, n_mfcc, type);
+    if (layout == Layout::TimeMajor) {
+        for (int t = 0; t < n_frames; ++t)
+            mfcc.compute(spectrogram[t], rows[t]);
+        return;
+    }
+    const int bins = fft_size / 2 + 1;
+    const int elem = spectrum_values(type, 1);
+    thread_local std::vector<double> in_storage, out_storage;
+    double* in = thread_buffer(in_storage, static_cast<size_t>(kBlockFrames) * bins * elem);
+    double* out = thread_buffer(out_storage, static_cast<size_t>(kBlockFrames) * n_mfcc);
+    for (int first = 0; first < n_frames; first += kBlockFrames) {
+        const int count = std::min(kBlockFrames, n_frames - first);
+        gather_block(spectrogram, first, count, bins, elem, in);
+        for (int i = 0; i < count; ++i)
+            mfcc.compute(in + static_cast<size_t>(i) * bins * elem, out + static_cast<size_t>(i) * n_mfcc);
+        scatter_block(out, count, n_mfcc, 1, rows, first);
+    }
+}
+
+// row pointers into a flat row-major buffer of n_rows rows
+template <typename P>
+P* const* flat_rows(std::vector<P*>& storage, P* data, int n_rows, size_t row_len) {
+    P** rows = thread_buffer(storage, static_cast<size_t>(n_rows));
+    for (int r = 0; r < n_rows; ++r) rows[r] = data + r * row_len;
+    return rows;
+}
+
+template <typename T>
+void stft_flat(const T* signal, size_t n, int win_len, int hop_len, int n_fft, bool center, PadMode pad_mode,
+               const WindowSpec& window, SpectrumType spectrum, double* out, Layout layout) {
+    const int frames = stft_num_frames(n, win_len, hop_len, n_fft, center);
+    const int bins = (n_fft > 0 ? n_fft : win_len) / 2 + 1;
+    const size_t elem = spectrum_values(spectrum, 1);
+    thread_local std::vector<double*> storage;
+    double* const* rows = layout == Layout::TimeMajor ? flat_rows(storage, out, frames, elem * bins)
+                                                      : flat_rows(storage, out, bins, elem * frames);
+    stft_kernel(signal, n, win_len, hop_len, n_fft, center, pad_mode, window, spectrum, layout, rows);
+}
+
+} // namespace
+
+Layout parse_layout(const std::string& name) {
+    if (name == "time") return Layout::TimeMajor;
+    if (name == "frequency") return Layout::FrequencyMajor;
+    throw std::invalid_argument("Unknown layout: " + name + " (expected time or frequency)");
+}
+
+const char* layout_name(Layout layout) {
+    return layout == Layout::FrequencyMajor ? "frequency" : "time";
+}
+
+int stft_num_frames(size_t n, int win_len, int hop_len, int n_fft, bool center) {
+    Framing framing = {checked_fft_size(win_len, hop_len, n_fft), hop_len, center, PadMode::Constant};
+    return framing.numFrames(n);
+}
+
+void compute_stft(const double* signal, size_t n, int win_len, int hop_len, int n_fft, bool center,
+                  PadMode pad_mode, const WindowSpec& window, SpectrumType spectrum, double* out, Layout layout) {
+    stft_flat(signal, n, win_len, hop_len, n_fft, center, pad_mode, window, spectrum, out, layout);
+}
+
+void compute_stft(const float* signal, size_t n, int win_len, int hop_len, int n_fft, bool center,
+                  PadMode pad_mode, const WindowSpec& window, SpectrumType spectrum, double* out, Layout layout) {
+    stft_flat(signal, n, win_len, hop_len, n_fft, center, pad_mode, window, spectrum, out, layout);
+}
+
+void compute_spectral_centroid(const double* spectrogram, int n_frames, int bins, int sample_rate, int fft_size,
+                               double* out) {
+    AF_TRACE_SCOPE("centroid");
+    const double bin_hz = static_cast<double>(sample_rate) / fft_size;
+    for (int t = 0; t < n_frames; ++t)
+        out[t] = spectral_centroid(spectrogram + static_cast<size_t>(t) * bins, bins, bin_hz);
+}
+
+void compute_spectral_rolloff(const double* spectrogram, int n_frames, int bins, int sample_rate, int fft_size,
+                              double rolloff_pct, double* out) {
+    AF_TRACE_SCOPE("rolloff");
+    const double bin_hz = static_cast<double>(sample_rate) / fft_size;
+    for (int t = 0; t < n_frames; ++t)
+        out[t] = spectral_rolloff(spectrogram + static_cast<size_t>(t) * bins, bins, bin_hz, rolloff_pct);
+}
+
+void compute_mfcc(const double* spectrogram, int n_frames, int sample_rate, int fft_size, int n_mel, int n_mfcc,
+                  SpectrumType spectrum, double* out, Layout layout) {
+    const size_t bins = fft_size / 2 + 1;
+    const size_t elem = spectrum_values(spectrum, 1);
+    thread_local std::vector<const double*> in_storage;
+    thread_local std::vector<double*> out_storage;
+    const double* const* in = layout == Layout::TimeMajor
+                                  ? flat_rows(in_storage, spectrogram, n_frames, bins * elem)
+                                  : flat_rows(in_storage, spectrogram, static_cast<int>(bins), elem * n_frames);
+    double* const* rows = layout == Layout::TimeMajor ? flat_rows(out_storage, out, n_frames, n_mfcc)
+                                                      : flat_rows(out_storage, out, n_mfcc, n_frames);
+    mfcc_kernel(in, n_frames, sample_rate, fft_size, n_mel, n_mfcc, spectrum, layout, rows);
+}
+
 // STFT with windowing
 std::vector<std::vector<double>> compute_stft(const std::vector<double>& signal, int win_len, int hop_len) {
-    int num_frames = (signal.size() - win_len) / hop_len + 1;
+    return compute_stft(signal, win_len, hop_len, win_len);
+}
 
-    // Hann window
-    std::vector<double> window(win_len);
-    for (int i = 0; i < win_len; ++i)
-        window[i] = 0.5 * (1 - std::cos(2 * M_PI * i / (win_len - 1)));
+std::vector<std::vector<double>> compute_stft(const std::vector<double>& signal, int win_len, int hop_len,
+                                              int n_fft, bool center, PadMode pad_mode, const WindowSpec& window,
+                                              SpectrumType type, Layout layout) {
+    const int num_frames = stft_num_frames(signal.size(), win_len, hop_len, n_fft, center);
+    if (num_frames == 0) return {};
+    const int bins = (n_fft > 0 ? n_fft : win_len) / 2 + 1;
 
+    // output rows allocated up front, the kernel writes through row pointers in either layout
     std::vector<std::vector<double>> spectrogram;
+    if (layout == Layout::TimeMajor)
+        spectrogram.assign(num_frames, std::vector<double>(spectrum_values(type, bins)));
+    else
+        spectrogram.assign(bins, std::vector<double>(static_cast<size_t>(spectrum_values(type, 1)) * num_frames));
+    std::vector<double*> rows(spectrogram.size());
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = spectrogram[i].data();
+    stft_kernel(signal.data(), signal.size(), win_len, hop_len, n_fft, center, pad_mode, window, type, layout,
+                rows.data());
+    return spectrogram;
+}
 
-    for (int frame = 0; frame < num_frames; ++frame) {
-        std::vector<double> segment(win_len);
-        for (int i = 0; i < win_len; ++i)
-            segment[i] = signal[frame * hop_len + i] * window[i];
+std::vector<std::vector<std::complex<double>>> compute_stft_complex(const std::vector<double>& signal, int win_len,
+                                                                    int hop_len, int n_fft, bool center,
+                                                                    PadMode pad_mode, const WindowSpec& window) {
+    AF_TRACE_SCOPE("compute_stft_complex");
+    n_fft = checked_fft_size(win_len, hop_len, n_fft);
 
-        auto fft_result = compute_fft(segment);
+    Framing framing = {n_fft, hop_len, center, pad_mode};
+    int num_frames = framing.numFrames(signal.size());
 
-        std::vector<double> magnitude(fft_result.size());
-        for (size_t k = 0; k < fft_result.size(); ++k)
-            magnitude[k] = std::abs(fft_result[k]);
+    SpectrumProcessor spectrum(win_len, n_fft, window);
+    std::vector<std::vector<std::complex<double>>> stft(num_frames, std::vector<std::complex<double>>(spectrum.bins()));
+    std::vector<double> scratch(n_fft);
 
-        spectrogram.push_back(std::move(magnitude));
+    for (int frame = 0; frame < num_frames; ++frame) {
+        const double* samples = frame_at(signal.data(), signal.size(), framing, frame, scratch.data());
+        spectrum.complex(samples, stft[frame].data());
     }
-
-    return spectrogram;
+    return stft;
 }
 
 // Spectral Centroid
+double spectral_centroid(const double* magnitude, int bins, double bin_hz) {
+    double weighted_sum = 0.0;
+    double magnitude_sum = 0.0;
+
+    for (int k = 0; k < bins; ++k) {
+        weighted_sum += k * bin_hz * magnitude[k];  // bin index * frequency * magnitude
+        magnitude_sum += magnitude[k];
+    }
+
+    return magnitude_sum > 1e-6 ? weighted_sum / magnitude_sum : 0.0;
+}
+
 std::vector<double> compute_spectral_centroid(const std::vector<std::vector<double>>& spectrogram, int sample_rate, int fft_size) {
+    AF_TRACE_SCOPE("centroid");
     std::vector<double> centroids;
+    centroids.reserve(spectrogram.size());
 
     double bin_hz = static_cast<double>(sample_rate) / fft_size;
 
-    for (const auto& frame : spectrogram) {
-        double weighted_sum = 0.0;
-        double magnitude_sum = 0.0;
-
-        for (size_t k = 0; k < frame.size(); ++k) {
-            weighted_sum += k * bin_hz * frame[k];  // bin index * frequency * magnitude
-            magnitude_sum += frame[k];
-        }
-
-        if (magnitude_sum > 1e-6)
-            centroids.push_back(weighted_sum / magnitude_sum);
-        else
-            centroids.push_back(0.0);
-    }
+    for (const auto& frame : spectrogram)
+        centroids.push_back(spectral_centroid(frame.data(), frame.size(), bin_hz));
 
     return centroids;
 }
 
 // Spectral Rolloff (frequency below which 99 percent of spectral energy is contained)
+double spectral_rolloff(const double* magnitude, int bins, double bin_hz, double rolloff_pct) {
+    double total_energy = 0;
+    for (int k = 0; k < bins; ++k) total_energy += magnitude[k];
+    double threshold = rolloff_pct * total_energy;
+
+    double cumulative = 0;
+    int roll_bin = bins - 1;
+    for (int k = 0; k < bins; ++k) {
+        cumulative += magnitude[k];
+        if (cumulative >= threshold) { roll_bin = k; break; }
+    }
+    return roll_bin * bin_hz;
+}
+
 std::vector<double> compute_spectral_rolloff(
     const std::vector<std::vector<double>>& spectrogram,
     int sample_rate, int fft_size, double rolloff_pct) {
 
-    int bins = spectrogram[0].size();
+    AF_TRACE_SCOPE("rolloff");
     double bin_hz = static_cast<double>(sample_rate) / fft_size;
     std::vector<double> rolloffs;
     rolloffs.reserve(spectrogram.size());
 
-    for (const auto& frame : spectrogram) {
-        double total_energy = 0;
-        for (double mag : frame) total_energy += mag;
-        double threshold = rolloff_pct * total_energy;
-
-        double cumulative = 0;
-        int roll_bin = bins - 1;
-        for (int k = 0; k < bins; ++k) {
-            cumulative += frame[k];
-            if (cumulative >= threshold) { roll_bin = k; break; }
-        }
-        rolloffs.push_back(roll_bin * bin_hz);
-    }
+    for (const auto& frame : spectrogram)
+        rolloffs.push_back(spectral_rolloff(frame.data(), frame.size(), bin_hz, rolloff_pct));
     return rolloffs;
 }
 
@@ -114,11 +452,8 @@ std::vector<double> compute_spectral_rolloff(
 double hz_to_mel(double hz) { return 2595 * std::log10(1 + hz / 700.0); }
 double mel_to_hz(double mel) { return 700 * (std::pow(10, mel / 2595.0) - 1); }
 
-std::vector<std::vector<double>> compute_mfcc(
-    const std::vector<std::vector<double>>& spectrogram,
-    int sample_rate, int fft_size, int n_mel=26, int n_mfcc=13) {
-
-    int n_frames = spectrogram.size();
+// Mel filterbank (shared by compute_mfcc and the streaming engine)
+std::vector<std::vector<double>> mel_filterbank(int sample_rate, int fft_size, int n_mel) {
     int n_bins = fft_size / 2 + 1;
     double max_mel = hz_to_mel(sample_rate / 2.0);
     double min_mel = hz_to_mel(0.0);
@@ -141,23 +476,202 @@ std::vector<std::vector<double>> compute_mfcc(
         for (int k = f_m; k < f_m_plus; ++k)
             mel_filterbank[m - 1][k] = (f_m_plus - k) / double(f_m_plus - f_m);
     }
+    return mel_filterbank;
+}
 
-    std::vector<std::vector<double>> mfccs(n_frames, std::vector<double>(n_mfcc));
-    for (int t = 0; t < n_frames; ++t) {
-        std::vector<double> mel_energies(n_mel, 0.0);
+std::vector<std::vector<double>> compute_mfcc(
+    const std::vector<std::vector<double>>& spectrogram,
+    int sample_rate, int fft_size, int n_mel, int n_mfcc, SpectrumType spectrum, Layout layout) {
+
+    // the kernel reads fft_size / 2 + 1 bins per frame through raw row pointers, so the shape is checked here
+    const size_t elem = static_cast<size_t>(spectrum_values(spectrum, 1));
+    const size_t bins = static_cast<size_t>(fft_size / 2 + 1);
+    if (layout == Layout::TimeMajor) {
+        for (const std::vector<double>& row : spectrogram)
+            if (row.size() != bins * elem)
+                throw std::invalid_argument("spectrogram rows must have fft_size / 2 + 1 = " + std::to_string(bins) +
+                                            " bins" + (elem > 1 ? " (re/im interleaved)" : ""));
+    } else if (!spectrogram.empty()) {
+        if (spectrogram.size() != bins)
+            throw std::invalid_argument("a frequency-major spectrogram needs fft_size / 2 + 1 = " +
+                                        std::to_string(bins) + " rows");
+        for (const std::vector<double>& row : spectrogram)
+            if (row.size() != spectrogram[0].size() || row.size() % elem != 0)
+                throw std::invalid_argument("frequency-major spectrogram rows must all hold the same frames");
+    }
+
+    // frequency-major rows are bins, each holding every frame
+    const int n_frames = layout == Layout::TimeMajor
+                             ? static_cast<int>(spectrogram.size())
+                             : (spectrogram.empty() ? 0 : static_cast<int>(spectrogram[0].size() /
+                                                                           spectrum_values(spectrum, 1)));
+    std::vector<std::vector<double>> mfccs = layout == Layout::TimeMajor
+        ? std::vector<std::vector<double>>(n_frames, std::vector<double>(n_mfcc))
+        : std::vector<std::vector<double>>(n_mfcc, std::vector<double>(n_frames));
+    std::vector<const double*> in(spectrogram.size());
+    for (size_t i = 0; i < in.size(); ++i) in[i] = spectrogram[i].data();
+    std::vector<double*> rows(mfccs.size());
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = mfccs[i].data();
+    mfcc_kernel(in.data(), n_frames, sample_rate, fft_size, n_mel, n_mfcc, spectrum, layout, rows.data());
+    return mfccs;
+}
+
+// Per-frame kernels
+
+SpectrumProcessor::SpectrumProcessor(int win_len, int n_fft, const WindowSpec& window)
+    : window_(get_window(window, win_len)),
+      offset_(n_fft > win_len ? (n_fft - win_len) / 2 : 0),
+      fft_(n_fft > win_len ? n_fft : win_len) {
+}
+
+template <typename T>
+void SpectrumProcessor::applyWindow(const T* frame) {
+    AF_TRACE_SCOPE("window");
+    // frame copy and window multiply in one pass over aligned buffers (vectorized at -O3);
+    // only the windowed span is written, the zero padding around it was set when the plan was made
+    double* __restrict in = fft_.input() + offset_;
+    const T* __restrict samples = frame + offset_;
+    const double* __restrict w = window_->data();
+    const int n = window_->size();
+    for (int i = 0; i < n; ++i)
+        in[i] = samples[i] * w[i];
+}
+
+void SpectrumProcessor::transform() {
+    AF_TRACE_SCOPE("fft");
+    fft_.execute();
+}
+
+// one kernel per output form over the interleaved FFT output; straight loops over restrict pointers
+// so -O3 vectorizes them, and only the magnitude kernel pays for a sqrt
+namespace {
+
+void magnitude_kernel(const double* __restrict spec, int bins, double* __restrict out) {
+    for (int k = 0; k < bins; ++k)
+        out[k] = std::sqrt(spec[2 * k] * spec[2 * k] + spec[2 * k + 1] * spec[2 * k + 1]);
+}
+
+void power_kernel(const double* __restrict spec, int bins, double* __restrict out) {
+    for (int k = 0; k < bins; ++k)
+        out[k] = spec[2 * k] * spec[2 * k] + spec[2 * k + 1] * spec[2 * k + 1];
+}
+
+void log_power_kernel(const double* __restrict spec, int bins, double* __restrict out) {
+    power_kernel(spec, bins, out);
+    for (int k = 0; k < bins; ++k)
+        out[k] = 10.0 * std::log10(std::max(out[k], 1e-10));
+}
+
+} // namespace
+
+void SpectrumProcessor::convert(SpectrumType type, double* out) const {
+    AF_TRACE_SCOPE("magnitude");
+    const double* spec = &fft_.output()[0][0];
+    const int bins = fft_.bins();
+    switch (type) {
+        case SpectrumType::Complex: std::copy(spec, spec + 2 * bins, out); break;
+        case SpectrumType::Magnitude: magnitude_kernel(spec, bins, out); break;
+        case SpectrumType::Power: power_kernel(spec, bins, out); break;
+        case SpectrumType::LogPower: log_power_kernel(spec, bins, out); break;
+    }
+}
+
+void SpectrumProcessor::compute(const double* frame, SpectrumType type, double* out) {
+    applyWindow(frame);
+    transform();
+    convert(type, out);
+}
+
+void SpectrumProcessor::compute(const float* frame, SpectrumType type, double* out) {
+    applyWindow(frame);
+    transform();
+    convert(type, out);
+}
+
+void SpectrumProcessor::magnitude(const double* frame, double* out) {
+    compute(frame, SpectrumType::Magnitude, out);
+}
+
+void SpectrumProcessor::magnitude(const float* frame, double* out) {
+    compute(frame, SpectrumType::Magnitude, out);
+}
+
+// std::complex<T> is layout compatible with T[2], the interleaved output is copied straight in
+void SpectrumProcessor::complex(const double* frame, std::complex<double>* out) {
+    compute(frame, SpectrumType::Complex, reinterpret_cast<double*>(out));
+}
+
+void SpectrumProcessor::complex(const float* frame, std::complex<double>* out) {
+    compute(frame, SpectrumType::Complex, reinterpret_cast<double*>(out));
+}
+
+void SpectrumProcessor::complex(const double* frame, std::complex<float>* out) {
+    applyWindow(frame);
+    transform();
+    const double* spec = &fft_.output()[0][0];
+    float* dst = reinterpret_cast<float*>(out);
+    const int n = 2 * fft_.bins();
+    for (int i = 0; i < n; ++i)
+        dst[i] = static_cast<float>(spec[i]);
+}
+
+MfccProcessor::MfccProcessor(int sample_rate, int fft_size, int n_mel, int n_mfcc, SpectrumType input)
+    : n_mel_(n_mel), n_mfcc_(n_mfcc), input_(input), start_(n_mel), weights_(n_mel), dct_(n_mfcc * n_mel),
+      mel_(n_mel) {
+    if (input == SpectrumType::Complex || input == SpectrumType::LogPower) power_.resize(fft_size / 2 + 1);
+    // keep only the non-zero span of each triangular filter
+    std::vector<std::vector<double>> filterbank = mel_filterbank(sample_rate, fft_size, n_mel);
+    for (int m = 0; m < n_mel; ++m) {
+        const std::vector<double>& filter = filterbank[m];
+        int first = 0;
+        while (first < (int)filter.size() && filter[first] == 0.0) ++first;
+        int last = (int)filter.size();
+        while (last > first && filter[last - 1] == 0.0) --last;
+        start_[m] = first;
+        weights_[m].assign(filter.begin() + first, filter.begin() + last);
+    }
+
+    for (int i = 0; i < n_mfcc; ++i)
         for (int m = 0; m < n_mel; ++m)
-            for (int k = 0; k < n_bins; ++k)
-                mel_energies[m] += spectrogram[t][k] * mel_filterbank[m][k];
-        for (auto& e : mel_energies) e = std::log(e + 1e-10);
+            dct_[i * n_mel + m] = std::cos(M_PI * i * (m + 0.5) / n_mel);
+}
 
-        for (int i = 0; i < n_mfcc; ++i) {
-            double sum = 0;
-            for (int m = 0; m < n_mel; ++m)
-                sum += mel_energies[m] * std::cos(M_PI * i * (m + 0.5) / n_mel);
-            mfccs[t][i] = sum;
-        }
+void MfccProcessor::melEnergies(const double* spectrum, double* mel_out) {
+    AF_TRACE_SCOPE("mel");
+    if (input_ == SpectrumType::Complex) {
+        power_kernel(spectrum, static_cast<int>(power_.size()), power_.data());
+        spectrum = power_.data();
+    } else if (input_ == SpectrumType::LogPower) {
+        for (size_t k = 0; k < power_.size(); ++k)
+            power_[k] = std::pow(10.0, spectrum[k] / 10.0);
+        spectrum = power_.data();
+    }
+    for (int m = 0; m < n_mel_; ++m) {
+        const std::vector<double>& weights = weights_[m];
+        const double* mag = spectrum + start_[m];
+        double energy = 0.0;
+        for (size_t j = 0; j < weights.size(); ++j)
+            energy += mag[j] * weights[j];
+        mel_out[m] = energy;
+    }
+}
+
+void MfccProcessor::logMel(const double* spectrum, double* mel_out) {
+    melEnergies(spectrum, mel_out);
+    for (int m = 0; m < n_mel_; ++m)
+        mel_out[m] = std::log(mel_out[m] + 1e-10);
+}
+
+void MfccProcessor::compute(const double* spectrum, double* mfcc_out) {
+    logMel(spectrum, mel_.data());
+    AF_TRACE_SCOPE("dct");
+    for (int i = 0; i < n_mfcc_; ++i) {
+        const double* basis = dct_.data() + i * n_mel_;
+        double sum = 0;
+        for (int m = 0; m < n_mel_; ++m)
+            sum += mel_[m] * basis[m];
+        mfcc_out[i] = sum;
     }
-    return mfccs;
 }
 
 // add main function to use valgrind
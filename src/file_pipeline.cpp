@@ -0,0 +1,359 @@
+// Pipelined feature extraction for one long file, see file_pipeline.hpp
+// segment s goes to worker s % n_workers, so each ring has exactly one producer and one consumer and the
+// writer gets segments back in order by visiting the workers' output rings round robin
+
+#include <file_pipeline.hpp>
+#include <ring_buffer.hpp>
+#include <trace.hpp>
+#include <sndfile.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+struct Segment {
+    int64_t index = 0;
+    int64_t first_frame = 0;
+    std::vector<float> samples;  // padded-stream samples of its frames, read without centering
+    size_t n = 0;
+    FeatureSet features;
+};
+
+class Pipeline {
+public:
+    Pipeline(SNDFILE* file, const SF_INFO& info, const ExtractorConfig& config, const PipelineOptions& options,
+             const FrameSink& sink)
+        : file_(file), channels_(info.channels), n_real_(info.frames), eof_(false),
+          config_(config), options_(options), sink_(sink),
+          framing_{config.n_fft, config.hop_len, config.center, config.pad_mode},
+          segment_len_(static_cast<size_t>(options.segment_frames - 1) * config.hop_len + config.n_fft),
+          window_start_(0), decoded_(0), segments_(-1), failed_(false) {
+        const int n = options_.n_workers;
+        in_.resize(n);
+        out_.resize(n);
+        free_.resize(n);
+        for (int w = 0; w < n; ++w) {
+            in_[w].reset(new RingBuffer<Segment*>(options_.queue_depth));
+            out_[w].reset(new RingBuffer<Segment*>(options_.queue_depth));
+            free_[w].reset(new RingBuffer<Segment*>(options_.queue_depth));
+            for (int d = 0; d < options_.queue_depth; ++d) {
+                pool_.emplace_back(new Segment());
+                pool_.back()->samples.resize(segment_len_);
+                Segment* slot = pool_.back().get();
+                free_[w]->push(&slot, 1);
+            }
+        }
+        read_buf_.resize(static_cast<size_t>(options_.read_frames) * channels_);
+        window_.reserve(segment_len_ + options_.read_frames + framing_.padding() + 1);
+    }
+
+    PipelineStats run() {
+        std::vector<std::thread> threads;
+        threads.emplace_back(&Pipeline::guard, this, &Pipeline::read, 0);
+        for (int w = 0; w < options_.n_workers; ++w) threads.emplace_back(&Pipeline::guard, this, &Pipeline::work, w);
+        guard(&Pipeline::write, 0);
+        for (std::thread& t : threads) t.join();
+        if (error_) std::rethrow_exception(error_);
+
+        PipelineStats stats;
+        stats.channels = channels_;
+        stats.n_samples = n_real_;
+        stats.n_frames = framing_.numFrames(static_cast<size_t>(n_real_));
+        stats.segments = segments_.load();
+        stats.buffer_bytes = window_.capacity() * sizeof(float) + read_buf_.size() * sizeof(short);
+        for (const std::unique_ptr<Segment>& slot : pool_) {
+            const FeatureSet& f = slot->features;
+            stats.buffer_bytes += slot->samples.capacity() * sizeof(float) +
+                                  (f.spectrum.capacity() + f.centroid.capacity() + f.rolloff.capacity() +
+                                   f.mfcc.capacity()) * sizeof(double) +
+                                  (f.rms.capacity() + f.zcr.capacity()) * sizeof(float);
+        }
+        return stats;
+    }
+
+private:
+    // any stage failing stops all of them, the first exception is rethrown by run()
+    void guard(void (Pipeline::*stage)(int), int w) {
+        try {
+            (this->*stage)(w);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            if (!error_) error_ = std::current_exception();
+            failed_ = true;
+        }
+        wake_.notify_all();
+    }
+
+    // waits until ready() or the pipeline failed; a missed notify costs at most the timeout
+    template <typename Ready>
+    bool waitFor(Ready ready) {
+        while (!ready()) {
+            if (failed_.load()) return false;
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        return !failed_.load();
+    }
+
+    // decodes until window_ covers real samples [.., end) or the file ends
+    void decodeTo(int64_t end) {
+        while (!eof_ && decoded_ < end) {
+            AF_TRACE_SCOPE("pipeline_read");
+            sf_count_t got = sf_readf_short(file_, read_buf_.data(), options_.read_frames);
+            if (got <= 0) {
+                // header announced more frames than there are
+                eof_ = true;
+                n_real_ = decoded_;
+                break;
+            }
+            // same conversion as get_wav_data, multichannel frames averaged like extract_files
+            const float scale = 1.0f / channels_;
+            for (sf_count_t i = 0; i < got; ++i) {
+                if (channels_ == 1) {
+                    window_.push_back(static_cast<float>(read_buf_[i]) / 32768.0f);
+                    continue;
+                }
+                float sum = 0.0f;
+                for (int c = 0; c < channels_; ++c)
+                    sum += static_cast<float>(read_buf_[i * channels_ + c]) / 32768.0f;
+                window_.push_back(sum * scale);
+            }
+            decoded_ += got;
+            if (decoded_ >= n_real_) {
+                eof_ = true;
+                n_real_ = decoded_;
+            }
+        }
+    }
+
+    // real sample j of the padded stream, j may lie in the padding
+    float sampleAt(int64_t j) const {
+        if (j < 0 || j >= n_real_) {
+            j = pad_index(j, static_cast<size_t>(n_real_), config_.pad_mode);
+            if (j < 0) return 0.0f;
+        }
+        return window_[j - window_start_];
+    }
+
+    void read(int) {
+        const long pad = framing_.padding();
+        int64_t first = 0;
+        for (int64_t s = 0;; ++s) {
+            // a segment's real samples, plus the ones the edge padding mirrors
+            int64_t lo = framing_.start(static_cast<int>(first));
+            int64_t hi = lo + static_cast<int64_t>(segment_len_);
+            decodeTo(std::max<int64_t>(hi, pad + 1));
+            const int64_t total = framing_.numFrames(static_cast<size_t>(n_real_));
+            if (first >= total) {
+                segments_ = s;
+                return;
+            }
+            const int count = static_cast<int>(std::min<int64_t>(options_.segment_frames, total - first));
+
+            const int w = static_cast<int>(s % options_.n_workers);
+            Segment* slot = nullptr;
+            if (!waitFor([&] { return free_[w]->pop(&slot, 1) == 1; })) return;
+            slot->index = s;
+            slot->first_frame = first;
+            slot->n = static_cast<size_t>(count - 1) * config_.hop_len + config_.n_fft;
+            for (size_t i = 0; i < slot->n; ++i) slot->samples[i] = sampleAt(lo + static_cast<int64_t>(i));
+            in_[w]->push(&slot, 1);
+            wake_.notify_all();
+
+            // keep what the next segment overlaps, and near the end what the right padding mirrors
+            first += count;
+            int64_t keep = std::min<int64_t>(framing_.start(static_cast<int>(first)), n_real_ - 1 - pad);
+            keep = std::max<int64_t>(0, std::min(keep, decoded_));
+            if (keep > window_start_) {
+                window_.erase(window_.begin(), window_.begin() + (keep - window_start_));
+                window_start_ = keep;
+            }
+        }
+    }
+
+    void work(int w) {
+        ExtractorConfig plain = config_;
+        plain.center = false;  // the padding is already in the segment
+        Extractor extractor(plain);
+        for (int64_t s = w;; s += options_.n_workers) {
+            Segment* slot = nullptr;
+            if (!waitFor([&] {
+                    if (in_[w]->pop(&slot, 1) == 1) return true;
+                    int64_t n = segments_.load();
+                    return n >= 0 && s >= n;
+                })) return;
+            if (!slot) return;  // all segments read
+            extractor.process(slot->samples.data(), slot->n, slot->features);
+            out_[w]->push(&slot, 1);
+            wake_.notify_all();
+        }
+    }
+
+    void write(int) {
+        for (int64_t s = 0;; ++s) {
+            const int w = static_cast<int>(s % options_.n_workers);
+            Segment* slot = nullptr;
+            if (!waitFor([&] {
+                    if (out_[w]->pop(&slot, 1) == 1) return true;
+                    int64_t n = segments_.load();
+                    return n >= 0 && s >= n;
+                })) return;
+            if (!slot) return;
+            {
+                AF_TRACE_SCOPE("pipeline_write");
+                sink_(slot->features, slot->first_frame);
+            }
+            free_[w]->push(&slot, 1);
+            wake_.notify_all();
+        }
+    }
+
+    // reader state
+    SNDFILE* file_;
+    int channels_;
+    int64_t n_real_;                 // real samples per channel, corrected at EOF
+    bool eof_;
+    std::vector<short> read_buf_;
+    std::vector<float> window_;      // decoded mono samples [window_start_, decoded_)
+    ExtractorConfig config_;
+    PipelineOptions options_;
+    const FrameSink& sink_;
+    Framing framing_;
+    size_t segment_len_;
+    int64_t window_start_;
+    int64_t decoded_;
+
+    std::vector<std::unique_ptr<Segment>> pool_;
+    std::vector<std::unique_ptr<RingBuffer<Segment*>>> in_;    // reader -> worker
+    std::vector<std::unique_ptr<RingBuffer<Segment*>>> out_;   // worker -> writer
+    std::vector<std::unique_ptr<RingBuffer<Segment*>>> free_;  // writer -> reader
+    std::atomic<int64_t> segments_;  // total, -1 until the reader is done
+    std::atomic<bool> failed_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::exception_ptr error_;
+};
+
+} // namespace
+
+PipelineStats extract_file_pipelined(const std::string& path, const ExtractorConfig& config,
+                                     const PipelineOptions& options, const FrameSink& sink) {
+    if (options.segment_frames < 1 || options.n_workers < 1 || options.queue_depth < 1 || options.read_frames < 1)
+        throw std::invalid_argument("segment_frames, n_workers, queue_depth and read_frames must be positive");
+
+    SF_INFO info = {0};
+    SNDFILE* file = sf_open(path.c_str(), SFM_READ, &info);
+    if (!file) throw std::runtime_error("Cannot open " + path + ": " + sf_strerror(nullptr));
+    std::unique_ptr<SNDFILE, int (*)(SNDFILE*)> close_file(file, sf_close);
+    if (info.channels < 1) throw std::runtime_error("No channels in " + path);
+
+    ExtractorConfig file_config = config;
+    file_config.sample_rate = info.samplerate;
+    Extractor check(file_config);  // invalid configs throw here, before any thread starts
+    (void)check;
+
+    Pipeline pipeline(file, info, file_config, options, sink);
+    PipelineStats stats = pipeline.run();
+    stats.sample_rate = info.samplerate;
+    return stats;
+}
+
+// ---------------------------------------------------------------- NpyFeatureWriter
+
+NpyFeatureWriter::NpyFeatureWriter(const std::string& dir, const ExtractorConfig& config, int n_bins)
+    : rows_(0) {
+    struct Spec { unsigned flag; const char* name; const char* descr; int64_t width; };
+    const bool complex = config.spectrum == SpectrumType::Complex;
+    const Spec specs[] = {
+        {FEATURE_SPECTRUM, "spectrum", complex ? "<c16" : "<f8", n_bins},
+        {FEATURE_CENTROID, "centroid", "<f8", 0},
+        {FEATURE_ROLLOFF, "rolloff", "<f8", 0},
+        {FEATURE_MFCC, "mfcc", "<f8", config.n_mfcc},
+        {FEATURE_RMS, "rms", "<f4", 0},
+        {FEATURE_ZCR, "zcr", "<f4", 0},
+    };
+    for (const Spec& spec : specs) {
+        if (!(config.features & spec.flag)) continue;
+        Column column = {spec.flag, dir + "/" + spec.name + ".npy", nullptr, spec.descr, spec.width};
+        column.file = std::fopen(column.path.c_str(), "wb");
+        if (!column.file) {
+            for (Column& c : columns_) std::fclose(c.file);
+            throw std::runtime_error("Cannot create " + column.path);
+        }
+        columns_.push_back(column);
+        writeHeader(columns_.back(), 0);
+    }
+}
+
+NpyFeatureWriter::~NpyFeatureWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+// fixed 128-byte header so the final row count can be written over the placeholder
+void NpyFeatureWriter::writeHeader(Column& column, int64_t rows) {
+    std::string shape = column.width > 0 ? "(" + std::to_string(rows) + ", " + std::to_string(column.width) + ")"
+                                         : "(" + std::to_string(rows) + ",)";
+    std::string dict = "{'descr': '" + column.descr + "', 'fortran_order': False, 'shape': " + shape + ", }";
+    const size_t header_len = 128 - 10;
+    dict.resize(header_len - 1, ' ');
+    dict += '\n';
+    const unsigned char preamble[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                        static_cast<unsigned char>(header_len & 0xff),
+                                        static_cast<unsigned char>(header_len >> 8)};
+    if (std::fseek(column.file, 0, SEEK_SET) != 0 || std::fwrite(preamble, 1, 10, column.file) != 10 ||
+        std::fwrite(dict.data(), 1, dict.size(), column.file) != dict.size())
+        throw std::runtime_error("Cannot write " + column.path);
+}
+
+void NpyFeatureWriter::write(const FeatureSet& frames, int64_t first_frame) {
+    if (first_frame != rows_) throw std::invalid_argument("NpyFeatureWriter: frames must arrive in order");
+    // the files are little-endian, like every platform this builds on
+    const size_t n = static_cast<size_t>(frames.n_frames);
+    for (Column& column : columns_) {
+        const void* data = nullptr;
+        size_t bytes = 0;
+        switch (column.feature) {
+            case FEATURE_SPECTRUM: data = frames.spectrum.data(); bytes = frames.spectrum.size() * sizeof(double); break;
+            case FEATURE_CENTROID: data = frames.centroid.data(); bytes = n * sizeof(double); break;
+            case FEATURE_ROLLOFF: data = frames.rolloff.data(); bytes = n * sizeof(double); break;
+            case FEATURE_MFCC: data = frames.mfcc.data(); bytes = frames.mfcc.size() * sizeof(double); break;
+            case FEATURE_RMS: data = frames.rms.data(); bytes = n * sizeof(float); break;
+            case FEATURE_ZCR: data = frames.zcr.data(); bytes = n * sizeof(float); break;
+        }
+        if (bytes && std::fwrite(data, 1, bytes, column.file) != bytes)
+            throw std::runtime_error("Cannot write " + column.path);
+    }
+    rows_ += frames.n_frames;
+}
+
+void NpyFeatureWriter::close() {
+    std::string error;
+    for (Column& column : columns_) {
+        if (!column.file) continue;
+        try {
+            writeHeader(column, rows_);
+        } catch (const std::exception& e) {
+            if (error.empty()) error = e.what();
+        }
+        if (std::fclose(column.file) != 0 && error.empty()) error = "Cannot write " + column.path;
+        column.file = nullptr;
+    }
+    if (!error.empty()) throw std::runtime_error(error);
+}
+
+std::vector<std::string> NpyFeatureWriter::paths() const {
+    std::vector<std::string> paths;
+    for (const Column& column : columns_) paths.push_back(column.path);
+    return paths;
+}
@@ -0,0 +1,49 @@
+// Python bindings for the pipelined single-file extraction
+// the whole pipeline runs without the GIL, features go straight to .npy files
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <string>
+#include <vector>
+#include <file_pipeline.hpp>
+
+namespace py = pybind11;
+
+void bind_file_pipeline(py::module_& m) {
+    m.def("extract_file_to_npy", [](const std::string& path, const std::string& out_dir, const Extractor& extractor,
+                                    int segment_frames, int n_workers, int queue_depth) {
+              PipelineOptions options;
+              options.segment_frames = segment_frames;
+              options.n_workers = n_workers;
+              options.queue_depth = queue_depth;
+              ExtractorConfig config = extractor.config();
+
+              PipelineStats stats;
+              std::vector<std::string> paths;
+              {
+                  py::gil_scoped_release release;
+                  // n_bins only depends on n_fft, the file's sample rate doesn't change it
+                  NpyFeatureWriter writer(out_dir, config, extractor.numBins());
+                  stats = extract_file_pipelined(path, config, options, [&writer](const FeatureSet& frames,
+                                                                                  int64_t first_frame) {
+                      writer.write(frames, first_frame);
+                  });
+                  writer.close();
+                  paths = writer.paths();
+              }
+              py::dict d;
+              d["sample_rate"] = stats.sample_rate;
+              d["channels"] = stats.channels;
+              d["n_samples"] = stats.n_samples;
+              d["n_frames"] = stats.n_frames;
+              d["segments"] = stats.segments;
+              d["buffer_bytes"] = stats.buffer_bytes;
+              d["paths"] = paths;
+              return d;
+          },
+          py::arg("path"), py::arg("out_dir"), py::arg("extractor"), py::arg("segment_frames") = 1024,
+          py::arg("n_workers") = 2, py::arg("queue_depth") = 2,
+          "Features of one (long) WAV file with decoding, compute and writing overlapped in a bounded-memory "
+          "pipeline, written to <out_dir>/<feature>.npy; same frames as extractor.process() on the whole file "
+          "(averaged to mono, at the file's sample rate). Returns the run's stats and the written paths");
+}
@@ -0,0 +1,101 @@
+// File-backed virtual input device for AudioStreamer
+// reads a WAV file with libsndfile on its own thread and feeds it through streamCallback/processInput
+// exactly like a PortAudio input stream, either paced in real time or as fast as possible.
+// Jitter and xruns can be injected (seeded) to exercise the streaming path without hardware.
+
+#include "portaudio_capture.hpp"
+#include <sndfile.h>
+#include <iostream>
+#include <random>
+#include <chrono>
+
+bool AudioStreamer::startFile(const std::string& path, const FileSourceConfig& source) {
+    if (running_) return false;
+    if (source_thread_.joinable()) source_thread_.join();  // previous file already hit EOF
+
+    SF_INFO sfinfo = {0};
+    SNDFILE* file = sf_open(path.c_str(), SFM_READ, &sfinfo);
+    if (!file) {
+        std::cerr << "Failed to open file: " << sf_strerror(nullptr) << "\n";
+        return false;
+    }
+
+    // the file dictates the stream format for this session only, start() goes back to the configured rate
+    if (sfinfo.samplerate != configured_rate_)
+        std::cout << "File source: using file sample rate " << sfinfo.samplerate
+                  << " Hz instead of " << configured_rate_ << " Hz\n";
+    setStreamRate(sfinfo.samplerate);
+
+    device_ = paNoDevice;
+    channels_ = sfinfo.channels;
+    format_ = SampleFormat::Float32;
+    input_latency_ = 0.0;
+    callbacks_ = 0;
+    frames_ = 0;
+    xruns_ = 0;
+
+    if (engine_) {
+        // as fast as possible still means every frame: wait for the engine and its reader, never overrun them
+        engine_->setLossless(!source.realtime);
+        engine_->start();
+    }
+    running_ = true;
+    source_thread_ = std::thread(&AudioStreamer::runFileSource, this, static_cast<void*>(file), source);
+    return true;
+}
+
+void AudioStreamer::runFileSource(void* handle, FileSourceConfig source) {
+    SNDFILE* file = static_cast<SNDFILE*>(handle);
+    const int ch = channels_;
+    std::vector<float> block(static_cast<size_t>(frames_per_buffer_) * ch);
+
+    std::mt19937 rng(source.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point t0 = clock::now();
+    uint64_t produced = 0;        // frames read from the file (including dropped ones)
+    bool pending_overflow = false;
+
+    PaStreamCallbackTimeInfo timeInfo = {0.0, 0.0, 0.0};
+
+    while (running_) {
+        sf_count_t n = sf_readf_float(file, block.data(), frames_per_buffer_);
+        if (n <= 0) {
+            if (source.loop && sf_seek(file, 0, SEEK_SET) == 0) continue;
+            break;
+        }
+
+        // a real device delivers a buffer once it has been captured
+        produced += n;
+        if (source.realtime) {
+            double due = static_cast<double>(produced) / sample_rate_;
+            if (source.jitter_ms > 0.0) due += uniform(rng) * source.jitter_ms * 1e-3;
+            std::this_thread::sleep_until(t0 + std::chrono::duration_cast<clock::duration>(
+                                                   std::chrono::duration<double>(due)));
+        }
+
+        // injected xrun: this buffer never reaches the callback, the next one reports the overflow
+        if (source.xrun_probability > 0.0 && uniform(rng) < source.xrun_probability) {
+            pending_overflow = true;
+            continue;
+        }
+
+        if (!source.realtime && engine_)
+            while (running_ && !engine_->waitForSpace(static_cast<size_t>(n), std::chrono::milliseconds(10))) {}
+
+        timeInfo.inputBufferAdcTime = static_cast<double>(produced - n) / sample_rate_;
+        timeInfo.currentTime = std::chrono::duration<double>(clock::now() - t0).count();
+
+        PaStreamCallbackFlags flags = pending_overflow ? paInputOverflow : 0;
+        pending_overflow = false;
+        if (streamCallback(block.data(), nullptr, static_cast<unsigned long>(n), &timeInfo, flags, this) != paContinue)
+            break;
+    }
+
+    sf_close(file);
+    // not running means finished: the last frames are published before that is reported
+    if (!source.realtime && engine_)
+        while (running_ && !engine_->waitUntilProcessed(std::chrono::milliseconds(10))) {}
+    running_ = false;  // stop() still joins this thread and stops the feature engine
+}
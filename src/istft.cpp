@@ -0,0 +1,115 @@
+// Inverse STFT with overlap-add, see istft.hpp
+// the accumulator holds max(n_fft, hop_len) samples starting at the next unfinished output sample;
+// after each frame the first hop_len samples are final, normalized and shifted out
+
+#include <istft.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+InverseStft::InverseStft(int win_len, int hop_len, int n_fft, bool center, const WindowSpec& window)
+    : hop_len_(hop_len),
+      center_(center),
+      window_(get_window(window, win_len > 0 ? win_len : 1)),
+      offset_(n_fft > win_len ? (n_fft - win_len) / 2 : 0),
+      ifft_(n_fft > win_len ? n_fft : std::max(win_len, 2)),
+      skip_(0),
+      frames_(0) {
+    if (win_len < 2 || hop_len <= 0 || (n_fft > 0 && n_fft < win_len))
+        throw std::invalid_argument("need win_len >= 2, hop_len > 0 and n_fft >= win_len");
+    acc_.assign(std::max(ifft_.size(), hop_len_), 0.0);
+    norm_.assign(acc_.size(), 0.0);
+    reset();
+}
+
+void InverseStft::reset() {
+    std::fill(acc_.begin(), acc_.end(), 0.0);
+    std::fill(norm_.begin(), norm_.end(), 0.0);
+    skip_ = center_ ? ifft_.size() / 2 : 0;
+    frames_ = 0;
+}
+
+void InverseStft::addFrame(const std::complex<double>* spectrum) {
+    const int bins = ifft_.bins();
+    fftw_complex* in = ifft_.input();
+    for (int k = 0; k < bins; ++k) {
+        in[k][0] = spectrum[k].real();
+        in[k][1] = spectrum[k].imag();
+    }
+    {
+        AF_TRACE_SCOPE("ifft");
+        ifft_.execute();
+    }
+
+    AF_TRACE_SCOPE("overlap_add");
+    const double scale = 1.0 / ifft_.size();
+    const double* __restrict y = ifft_.output() + offset_;
+    const double* __restrict w = window_->data();
+    double* __restrict acc = acc_.data() + offset_;
+    double* __restrict norm = norm_.data() + offset_;
+    const int n = window_->size();
+    for (int i = 0; i < n; ++i) {
+        acc[i] += y[i] * scale * w[i];
+        norm[i] += w[i] * w[i];
+    }
+    ++frames_;
+}
+
+// normalize and hand out the first count accumulated samples, then shift the accumulator
+size_t InverseStft::emit(size_t count, double* out) {
+    const double tiny = std::numeric_limits<double>::min();
+    size_t written = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (skip_ > 0) {
+            --skip_;
+            continue;
+        }
+        out[written++] = norm_[i] > tiny ? acc_[i] / norm_[i] : acc_[i];
+    }
+    std::copy(acc_.begin() + count, acc_.end(), acc_.begin());
+    std::copy(norm_.begin() + count, norm_.end(), norm_.begin());
+    std::fill(acc_.end() - count, acc_.end(), 0.0);
+    std::fill(norm_.end() - count, norm_.end(), 0.0);
+    return written;
+}
+
+size_t InverseStft::process(const std::complex<double>* frames, int n_frames, double* out) {
+    AF_TRACE_SCOPE("istft");
+    const int bins = ifft_.bins();
+    size_t written = 0;
+    for (int t = 0; t < n_frames; ++t) {
+        addFrame(frames + static_cast<size_t>(t) * bins);
+        written += emit(hop_len_, out + written);
+    }
+    return written;
+}
+
+size_t InverseStft::flush(double* out, bool trim_padding) {
+    size_t written = 0;
+    if (frames_ > 0) {
+        // the last frame reaches n_fft - hop_len samples past what process() wrote; centered drops its padding
+        long tail = static_cast<long>(ifft_.size()) - hop_len_;
+        if (center_ && trim_padding) tail -= ifft_.size() / 2;
+        if (tail > 0) written = emit(static_cast<size_t>(tail), out);
+    }
+    reset();
+    return written;
+}
+
+std::vector<double> compute_istft(const std::vector<std::vector<std::complex<double>>>& stft, int win_len,
+                                  int hop_len, int n_fft, bool center, const WindowSpec& window, long length) {
+    InverseStft istft(win_len, hop_len, n_fft, center, window);
+    const size_t bins = static_cast<size_t>(istft.bins());
+
+    std::vector<double> signal(stft.size() * hop_len + istft.fftSize());
+    size_t written = 0;
+    for (const std::vector<std::complex<double>>& frame : stft) {
+        if (frame.size() != bins) throw std::invalid_argument("every frame needs n_fft / 2 + 1 bins");
+        written += istft.process(frame.data(), 1, signal.data() + written);
+    }
+    written += istft.flush(signal.data() + written, length < 0);
+
+    signal.resize(length >= 0 ? static_cast<size_t>(length) : written, 0.0);
+    return signal;
+}
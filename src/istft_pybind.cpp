@@ -0,0 +1,180 @@
+// Python bindings for the complex STFT, the streaming STFT and the inverse STFT
+// spectra are complex128 NumPy arrays [n_frames][n_fft // 2 + 1], written and read in place (no nested lists)
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/complex.h>
+#include <complex>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fft_stft.hpp>
+#include <istft.hpp>
+#include <stream_stft.hpp>
+#include <trace.hpp>
+
+namespace py = pybind11;
+
+namespace {
+
+using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using ComplexArray = py::array_t<std::complex<double>, py::array::c_style | py::array::forcecast>;
+
+// hand a vector's storage to NumPy, the capsule frees it with the array
+py::array_t<double> take_array(std::vector<double>& values) {
+    std::vector<double>* owned = new std::vector<double>(std::move(values));
+    py::capsule free_when_done(owned, [](void* p) { delete static_cast<std::vector<double>*>(p); });
+    return py::array_t<double>(static_cast<py::ssize_t>(owned->size()), owned->data(), free_when_done);
+}
+
+const std::complex<double>* frames_of(const ComplexArray& stft, int bins) {
+    if (stft.ndim() != 2 || stft.shape(1) != bins)
+        throw py::value_error("stft must have shape (n_frames, n_fft // 2 + 1) = (n, " + std::to_string(bins) + ")");
+    return stft.data();
+}
+
+// every frame of signal straight into the output array rows
+template <typename C>
+void write_frames(const DoubleArray& signal, const Framing& framing, SpectrumProcessor& spectrum, C* dst) {
+    py::gil_scoped_release release;
+    AF_TRACE_SCOPE("compute_stft_complex");
+    const size_t n = static_cast<size_t>(signal.shape(0));
+    const int frames = framing.numFrames(n);
+    std::vector<double> scratch(framing.n_fft);
+    for (int t = 0; t < frames; ++t)
+        spectrum.complex(frame_at(signal.data(), n, framing, t, scratch.data()),
+                         dst + static_cast<size_t>(t) * spectrum.bins());
+}
+
+// (index of the first frame, frames): `rows` frames written by run into a float64 (rows, bins) array,
+// complex128 for a complex spectrum
+// the GIL stays held from counting the rows to writing them, so no other thread can push in between and
+// make run() write more frames than the array holds
+template <typename F>
+py::tuple stream_frames(StreamingStft& self, int rows, F run) {
+    const int64_t first = self.framesEmitted();
+    std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(self.bins())};
+    py::array out;
+    if (self.spectrum() == SpectrumType::Complex) out = py::array_t<std::complex<double>>(shape);
+    else out = py::array_t<double>(shape);
+    run(static_cast<double*>(out.mutable_data()));
+    return py::make_tuple(first, out);
+}
+
+template <typename T>
+py::tuple push_block(StreamingStft& self, const py::array_t<T, py::array::c_style | py::array::forcecast>& block) {
+    if (block.ndim() != 1) throw py::value_error("samples must be one-dimensional");
+    const T* samples = block.data();
+    const size_t n = static_cast<size_t>(block.shape(0));
+    return stream_frames(self, self.numFrames(n), [&](double* out) { self.push(samples, n, out); });
+}
+
+} // namespace
+
+void bind_istft(py::module_& m) {
+    m.def("compute_stft_complex", [](const DoubleArray& signal, int win_len, int hop_len, int n_fft, bool center,
+                                     const std::string& pad_mode, const std::string& window, bool periodic,
+                                     double kaiser_beta, const std::string& dtype) -> py::object {
+        if (signal.ndim() != 1) throw py::value_error("signal must be one-dimensional");
+        if (n_fft <= 0) n_fft = win_len;
+        if (win_len <= 0 || hop_len <= 0 || n_fft < win_len)
+            throw py::value_error("need win_len > 0, hop_len > 0 and n_fft >= win_len");
+        Framing framing{n_fft, hop_len, center, parse_pad_mode(pad_mode)};
+        SpectrumProcessor spectrum(win_len, n_fft, make_window_spec(window, periodic, kaiser_beta));
+
+        if (dtype != "complex128" && dtype != "complex64")
+            throw py::value_error("dtype must be 'complex128' or 'complex64'");
+        const size_t n = static_cast<size_t>(signal.shape(0));
+        const int frames = framing.numFrames(n);
+        std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(frames), static_cast<py::ssize_t>(spectrum.bins())};
+        if (dtype == "complex64") {
+            py::array_t<std::complex<float>> out(shape);
+            write_frames(signal, framing, spectrum, out.mutable_data());
+            return std::move(out);
+        }
+        py::array_t<std::complex<double>> out(shape);
+        write_frames(signal, framing, spectrum, out.mutable_data());
+        return std::move(out);
+    }, py::arg("signal"), py::arg("win_len"), py::arg("hop_len"), py::arg("n_fft") = 0, py::arg("center") = false,
+       py::arg("pad_mode") = "constant", py::arg("window") = "hann", py::arg("periodic") = false,
+       py::arg("kaiser_beta") = 8.6, py::arg("dtype") = "complex128",
+       "Complex STFT as a complex128 (or complex64) array (n_frames, n_fft // 2 + 1), same framing as compute_stft");
+
+    m.def("compute_istft", [](const ComplexArray& stft, int win_len, int hop_len, int n_fft, bool center,
+                              const std::string& window, bool periodic, double kaiser_beta, long length) {
+        InverseStft istft(win_len, hop_len, n_fft, center, make_window_spec(window, periodic, kaiser_beta));
+        const std::complex<double>* frames = frames_of(stft, istft.bins());
+        const int n_frames = static_cast<int>(stft.shape(0));
+
+        // room for every frame plus the tail, trimmed to what was written (or to length) afterwards
+        std::vector<double> signal(static_cast<size_t>(n_frames) * hop_len + istft.fftSize());
+        size_t written;
+        {
+            py::gil_scoped_release release;
+            written = istft.process(frames, n_frames, signal.data());
+            written += istft.flush(signal.data() + written, length < 0);
+        }
+        signal.resize(length >= 0 ? static_cast<size_t>(length) : written, 0.0);
+        return take_array(signal);
+    }, py::arg("stft"), py::arg("win_len"), py::arg("hop_len"), py::arg("n_fft") = 0, py::arg("center") = false,
+       py::arg("window") = "hann", py::arg("periodic") = false, py::arg("kaiser_beta") = 8.6, py::arg("length") = -1,
+       "Inverse STFT by overlap-add with window-sum normalization; use the analysis parameters "
+       "(periodic windows with hop <= n_fft // 2 reconstruct exactly), length >= 0 trims or zero-pads");
+
+    py::class_<InverseStft>(m, "InverseStft",
+        "Block-streaming inverse STFT: process() returns the samples each batch of frames completes")
+        .def(py::init([](int win_len, int hop_len, int n_fft, bool center, const std::string& window, bool periodic,
+                         double kaiser_beta) {
+                 return std::unique_ptr<InverseStft>(new InverseStft(
+                     win_len, hop_len, n_fft, center, make_window_spec(window, periodic, kaiser_beta)));
+             }),
+             py::arg("win_len"), py::arg("hop_len"), py::arg("n_fft") = 0, py::arg("center") = false,
+             py::arg("window") = "hann", py::arg("periodic") = false, py::arg("kaiser_beta") = 8.6)
+        .def("process", [](InverseStft& self, const ComplexArray& stft) {
+            // under the GIL: the overlap-add tail is shared by every Python thread using this object
+            const std::complex<double>* frames = frames_of(stft, self.bins());
+            const int n_frames = static_cast<int>(stft.shape(0));
+            std::vector<double> out(static_cast<size_t>(n_frames) * self.hopLen());
+            out.resize(self.process(frames, n_frames, out.data()));
+            return take_array(out);
+        }, py::arg("stft"), "Add frames (n, n_fft // 2 + 1), returns the finished samples")
+        .def("flush", [](InverseStft& self, bool trim_padding) {
+            std::vector<double> out(self.fftSize());
+            out.resize(self.flush(out.data(), trim_padding));
+            return take_array(out);
+        }, py::arg("trim_padding") = true, "Return the remaining tail and reset")
+        .def("reset", &InverseStft::reset)
+        .def_property_readonly("n_fft", &InverseStft::fftSize)
+        .def_property_readonly("hop_len", &InverseStft::hopLen)
+        .def_property_readonly("frames_processed", &InverseStft::framesProcessed);
+
+    py::class_<StreamingStft>(m, "StreamingSTFT",
+        "Block-streaming STFT: push() returns the frames each block completes, all blocks plus flush() give "
+        "exactly compute_stft's frames of the concatenated signal")
+        .def(py::init([](int win_len, int hop_len, int n_fft, bool center, const std::string& pad_mode,
+                         const std::string& window, bool periodic, double kaiser_beta, const std::string& output) {
+                 return std::unique_ptr<StreamingStft>(new StreamingStft(
+                     win_len, hop_len, n_fft, center, parse_pad_mode(pad_mode),
+                     make_window_spec(window, periodic, kaiser_beta), parse_spectrum_type(output)));
+             }),
+             py::arg("win_len"), py::arg("hop_len"), py::arg("n_fft") = 0, py::arg("center") = false,
+             py::arg("pad_mode") = "constant", py::arg("window") = "hann", py::arg("periodic") = false,
+             py::arg("kaiser_beta") = 8.6, py::arg("output") = "magnitude")
+        .def("push", [](StreamingStft& self, const FloatArray& samples) { return push_block(self, samples); },
+             py::arg("samples"),
+             "Add the next samples, returns (first_index, frames): the frames they complete, (k, n_fft // 2 + 1) "
+             "float64 (complex128 for output='complex'), numbered from first_index in the stream")
+        .def("push", [](StreamingStft& self, const DoubleArray& samples) { return push_block(self, samples); },
+             py::arg("samples"))
+        .def("flush", [](StreamingStft& self) {
+            return stream_frames(self, self.flushFrames(), [&](double* out) { self.flush(out); });
+        }, "End of stream: (first_index, frames) reaching into the right padding (center=True), then reset")
+        .def("reset", &StreamingStft::reset, "Drop carried samples, the next push starts a new stream at frame 0")
+        .def("num_frames", &StreamingStft::numFrames, py::arg("n_samples"))
+        .def_property_readonly("frames_emitted", &StreamingStft::framesEmitted)
+        .def_property_readonly("samples_pushed", &StreamingStft::samplesPushed)
+        .def_property_readonly("n_fft", &StreamingStft::fftSize)
+        .def_property_readonly("hop_len", &StreamingStft::hopLen);
+}
@@ -1,55 +1,213 @@
 #include "portaudio_capture.hpp"
 #include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
 
-// add tiny delay debugging
-#include <thread>
-#include <chrono>
+namespace {
 
-AudioStreamer::AudioStreamer(int sample_rate, int frames_per_buffer)
+PaSampleFormat to_pa_format(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::Int16: return paInt16;
+        case SampleFormat::Int24: return paInt24;
+        case SampleFormat::Float32: return paFloat32;
+    }
+    return paFloat32;
+}
+
+std::string lowercase(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+} // namespace
+
+std::shared_ptr<PortAudioRuntime> PortAudioRuntime::acquire() {
+    static std::mutex runtime_mutex;
+    static std::weak_ptr<PortAudioRuntime> current;
+
+    std::lock_guard<std::mutex> lock(runtime_mutex);
+    std::shared_ptr<PortAudioRuntime> runtime = current.lock();
+    if (runtime) return runtime;
+
+    PaError err = Pa_Initialize();
+    if (err != paNoError)
+        throw std::runtime_error(std::string("Failed to initialize PortAudio: ") + Pa_GetErrorText(err));
+    runtime.reset(new PortAudioRuntime());
+    current = runtime;
+    return runtime;
+}
+
+PortAudioRuntime::~PortAudioRuntime() {
+    Pa_Terminate();
+}
+
+SampleFormat parse_sample_format(const std::string& name) {
+    std::string n = lowercase(name);
+    if (n == "int16") return SampleFormat::Int16;
+    if (n == "int24") return SampleFormat::Int24;
+    if (n == "float32") return SampleFormat::Float32;
+    throw std::invalid_argument("Unknown sample format '" + name + "' (expected int16, int24 or float32)");
+}
+
+const char* sample_format_name(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::Int16: return "int16";
+        case SampleFormat::Int24: return "int24";
+        case SampleFormat::Float32: return "float32";
+    }
+    return "unknown";
+}
+
+std::vector<InputDeviceInfo> list_input_devices() {
+    std::vector<InputDeviceInfo> devices;
+    std::shared_ptr<PortAudioRuntime> runtime = PortAudioRuntime::acquire();
+
+    PaDeviceIndex default_dev = Pa_GetDefaultInputDevice();
+    int count = Pa_GetDeviceCount();
+    for (int i = 0; i < count; ++i) {
+        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
+        if (!info || info->maxInputChannels < 1) continue;
+        const PaHostApiInfo* api = Pa_GetHostApiInfo(info->hostApi);
+
+        InputDeviceInfo d;
+        d.index = i;
+        d.name = info->name;
+        d.host_api = api ? api->name : "";
+        d.max_input_channels = info->maxInputChannels;
+        d.default_sample_rate = info->defaultSampleRate;
+        d.default_low_latency = info->defaultLowInputLatency;
+        d.default_high_latency = info->defaultHighInputLatency;
+        d.is_default = (i == default_dev);
+        devices.push_back(d);
+    }
+    return devices;
+}
+
+AudioStreamer::AudioStreamer(int sample_rate, int frames_per_buffer, const CaptureConfig& config)
     : stream_(nullptr),
+      buffer_(std::max(sample_rate, 1)),
+      buffer_head_(0),
+      buffer_size_(0),
       running_(false),
       sample_rate_(sample_rate),
-      frames_per_buffer_(frames_per_buffer) {
-    Pa_Initialize();
+      configured_rate_(sample_rate),
+      frames_per_buffer_(frames_per_buffer),
+      config_(config),
+      device_(paNoDevice),
+      channels_(0),
+      format_(config.sample_format),
+      input_latency_(0.0),
+      callbacks_(0),
+      frames_(0),
+      xruns_(0),
+      mono_(frames_per_buffer) {
 }
 
 AudioStreamer::~AudioStreamer() {
     stop();
-    Pa_Terminate();
 }
 
-bool AudioStreamer::start() {
-    if (running_) return false;
+// index > name > default input device
+PaDeviceIndex AudioStreamer::resolveDevice() const {
+    if (config_.device_index >= 0) {
+        if (config_.device_index >= Pa_GetDeviceCount()) {
+            std::cerr << "Input device index " << config_.device_index << " out of range" << std::endl;
+            return paNoDevice;
+        }
+        return config_.device_index;
+    }
+
+    if (!config_.device_name.empty()) {
+        std::string wanted = lowercase(config_.device_name);
+        int count = Pa_GetDeviceCount();
+        for (int i = 0; i < count; ++i) {
+            const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
+            if (info && info->maxInputChannels > 0 &&
+                lowercase(info->name).find(wanted) != std::string::npos)
+                return i;
+        }
+        std::cerr << "No input device matching '" << config_.device_name << "'" << std::endl;
+        return paNoDevice;
+    }
 
-    // safety checks
     PaDeviceIndex dev = Pa_GetDefaultInputDevice();
-    if (dev == paNoDevice) {
+    if (dev == paNoDevice)
         std::cerr << "No default input device found!" << std::endl;
-        return false;
+    return dev;
+}
+
+// Try the requested channel count and format first, then fall back to whatever the device accepts.
+// Fewer channels are preferred (everything is downmixed to mono anyway), then the requested format.
+bool AudioStreamer::negotiate(PaDeviceIndex dev, const PaDeviceInfo* devInfo, PaStreamParameters& params) const {
+    std::vector<int> channel_options = {std::min(std::max(config_.channels, 1), devInfo->maxInputChannels)};
+    for (int c : {1, 2, devInfo->maxInputChannels})
+        if (c <= devInfo->maxInputChannels &&
+            std::find(channel_options.begin(), channel_options.end(), c) == channel_options.end())
+            channel_options.push_back(c);
+
+    std::vector<SampleFormat> format_options = {config_.sample_format};
+    for (SampleFormat f : {SampleFormat::Int16, SampleFormat::Float32, SampleFormat::Int24})
+        if (f != config_.sample_format) format_options.push_back(f);
+
+    params.device = dev;
+    params.suggestedLatency = config_.latency > 0.0 ? config_.latency : devInfo->defaultLowInputLatency;
+    params.hostApiSpecificStreamInfo = nullptr;
+
+    for (int channels : channel_options) {
+        for (SampleFormat format : format_options) {
+            params.channelCount = channels;
+            params.sampleFormat = to_pa_format(format);
+            if (Pa_IsFormatSupported(&params, nullptr, sample_rate_) == paFormatIsSupported)
+                return true;
+        }
     }
+    return false;
+}
 
-    const PaDeviceInfo* devInfo = Pa_GetDeviceInfo(22);
-    //const PaDeviceInfo* devInfo = Pa_GetDeviceInfo(dev);
+bool AudioStreamer::start() {
+    if (running_) return false;
+    if (source_thread_.joinable()) source_thread_.join();  // previous file source already hit EOF
+
+    if (!portaudio_) {
+        try {
+            portaudio_ = PortAudioRuntime::acquire();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    setStreamRate(configured_rate_);  // a file session may have left its own rate behind
+
+    // safety checks
+    PaDeviceIndex dev = resolveDevice();
+    if (dev == paNoDevice) return false;
+
+    const PaDeviceInfo* devInfo = Pa_GetDeviceInfo(dev);
     if (!devInfo) {
         std::cerr << "Failed to get device info!" << std::endl;
         return false;
     }
 
     if (devInfo->maxInputChannels < 1) {
-        std::cerr << "Default input device does not support mono input!" << std::endl;
+        std::cerr << "Input device " << devInfo->name << " has no input channels!" << std::endl;
         return false;
     }
 
-        std::cout << "Using input device: " << devInfo->name << " with "
-              << devInfo->maxInputChannels << " channels, latency "
-              << devInfo->defaultLowInputLatency << " sec\n";
-    
     PaStreamParameters inputParams;
-    inputParams.device = 22; //dev;
-    inputParams.channelCount = 2;
-    inputParams.sampleFormat = paFloat32;
-    inputParams.suggestedLatency = devInfo->defaultLowInputLatency;
-    inputParams.hostApiSpecificStreamInfo = nullptr;
+    if (!negotiate(dev, devInfo, inputParams)) {
+        std::cerr << "No supported channel count / sample format for " << devInfo->name
+                  << " at " << sample_rate_ << " Hz" << std::endl;
+        return false;
+    }
+
+    device_ = dev;
+    channels_ = inputParams.channelCount;
+    format_ = inputParams.sampleFormat == paInt16 ? SampleFormat::Int16
+            : inputParams.sampleFormat == paInt24 ? SampleFormat::Int24
+            : SampleFormat::Float32;
 
     PaError err = Pa_OpenStream(
         &stream_,
@@ -64,26 +222,62 @@ bool AudioStreamer::start() {
 
     if (err != paNoError) {
         std::cerr << "Failed to open stream: " << Pa_GetErrorText(err) << "\n";
+        stream_ = nullptr;
         return false;
     }
 
+    const PaStreamInfo* streamInfo = Pa_GetStreamInfo(stream_);
+    input_latency_ = streamInfo ? streamInfo->inputLatency : inputParams.suggestedLatency;
+
+    std::cout << "Using input device: " << devInfo->name << " with "
+              << channels_ << " channel(s), " << sample_format_name(format_) << ", latency "
+              << input_latency_ << " sec\n";
+
+    if (engine_) {
+        engine_->setLossless(false);  // a device cannot wait, overruns are dropped and counted
+        engine_->start();
+    }
+
+    callbacks_ = 0;
+    frames_ = 0;
+    xruns_ = 0;
+
+    // the callback aborts when not running, so flag it before the first buffer can arrive
+    running_ = true;
     err = Pa_StartStream(stream_);
     if (err != paNoError) {
         std::cerr << "Failed to start stream: " << Pa_GetErrorText(err) << "\n";
+        running_ = false;
+        Pa_CloseStream(stream_);
+        stream_ = nullptr;
+        if (engine_) engine_->stop();
         return false;
     }
 
-    running_ = true;
     return true;
 }
 
 void AudioStreamer::stop() {
-    if (!running_) return;
-
-    Pa_StopStream(stream_);
-    Pa_CloseStream(stream_);
-    stream_ = nullptr;
+    // a file source clears running_ itself at end of file, so always reap the thread
     running_ = false;
+    if (source_thread_.joinable()) source_thread_.join();
+
+    if (stream_) {
+        Pa_StopStream(stream_);
+        Pa_CloseStream(stream_);
+        stream_ = nullptr;
+    }
+
+    if (engine_) engine_->stop();
+}
+
+// only while stopped: the Python buffer and the feature engine are sized for the stream's rate
+void AudioStreamer::setStreamRate(int rate) {
+    if (rate == sample_rate_) return;
+    sample_rate_ = rate;
+    flushBuffer();
+    buffer_.assign(std::max(rate, 1), 0.0f);
+    if (engine_) engine_.reset(new StreamFeatureEngine(sample_rate_, engine_->config()));
 }
 
 bool AudioStreamer::isRunning() const {
@@ -91,7 +285,7 @@ bool AudioStreamer::isRunning() const {
 }
 
 int AudioStreamer::streamCallback(const void* inputBuffer, void*, unsigned long framesPerBuffer,
-                                  const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags, void* userData) {
+                                  const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags statusFlags, void* userData) {
     // input buffer check
     if (inputBuffer == nullptr) {
         // Silence or input underflow; ignore or insert zeros if you want
@@ -102,40 +296,125 @@ int AudioStreamer::streamCallback(const void* inputBuffer, void*, unsigned long
     // add adefensive check so callback isn't ignored, check stream is running
     if (!self->isRunning()) return paAbort;
 
-    std::cerr << "[Callback] Received audio buffer with " << framesPerBuffer << " frames\n";
+    ++self->callbacks_;
+    self->frames_ += framesPerBuffer;
+    if (statusFlags & paInputOverflow) ++self->xruns_;
 
-    // inside streamCallback
-    // std::this_thread::sleep_for(std::chrono::milliseconds(1));
-
-    self->processInput(static_cast<const float*>(inputBuffer), framesPerBuffer);
+    self->processInput(inputBuffer, framesPerBuffer);
     return paContinue;
 }
 
-void AudioStreamer::processInput(const float* input, size_t frameCount) {
-    std::cout << "Processing " << frameCount << " frames\n";
-    std::lock_guard<std::mutex> lock(buffer_mutex_);
-    for (size_t i = 0; i < frameCount; ++i) {
-        float left = input[i * 2];     // Left channel
-        float right = input[i * 2 + 1]; // Right channel
+void AudioStreamer::processInput(const void* input, size_t frameCount) {
+    if (mono_.size() < frameCount) mono_.resize(frameCount);
 
-        float mono = 0.5f * (left + right); // Convert to mono
-        buffer_.push_back(mono);
-        if (buffer_.size() > sample_rate_) { // keep only 1 second
-            buffer_.erase(buffer_.begin(), buffer_.begin() + (buffer_.size() - sample_rate_));
-}
+    // interleaved channels_ x frameCount samples in the negotiated format, averaged down to mono
+    const int ch = channels_;
+    const float scale = 1.0f / ch;
+    switch (format_) {
+        case SampleFormat::Float32: {
+            const float* in = static_cast<const float*>(input);
+            for (size_t i = 0; i < frameCount; ++i) {
+                float sum = 0.0f;
+                for (int c = 0; c < ch; ++c) sum += in[i * ch + c];
+                mono_[i] = sum * scale;
+            }
+            break;
+        }
+        case SampleFormat::Int16: {
+            const int16_t* in = static_cast<const int16_t*>(input);
+            for (size_t i = 0; i < frameCount; ++i) {
+                int32_t sum = 0;
+                for (int c = 0; c < ch; ++c) sum += in[i * ch + c];
+                mono_[i] = sum * scale / 32768.0f;
+            }
+            break;
+        }
+        case SampleFormat::Int24: {
+            // packed little-endian 3 byte samples
+            const uint8_t* in = static_cast<const uint8_t*>(input);
+            for (size_t i = 0; i < frameCount; ++i) {
+                int32_t sum = 0;
+                for (int c = 0; c < ch; ++c) {
+                    const uint8_t* b = in + 3 * (i * ch + c);
+                    int32_t v = (int32_t)((uint32_t)b[0] << 8 | (uint32_t)b[1] << 16 | (uint32_t)b[2] << 24) >> 8;
+                    sum += v;
+                }
+                mono_[i] = sum * scale / 8388608.0f;
+            }
+            break;
+        }
+    }
+
+    // feature engine gets the samples lock-free, before we contend for the Python buffer
+    if (engine_) engine_->push(mono_.data(), frameCount);
+
+    // keep only the last second for getBufferedAudio: the ring overwrites its oldest samples, nothing allocates
+    const size_t capacity = buffer_.size();
+    const float* src = mono_.data();
+    size_t count = frameCount;
+    if (count > capacity) {
+        src += count - capacity;
+        count = capacity;
+    }
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    const size_t end = (buffer_head_ + buffer_size_) % capacity;
+    const size_t first = std::min(count, capacity - end);
+    std::copy(src, src + first, buffer_.begin() + end);
+    std::copy(src + first, src + count, buffer_.begin());
+    buffer_size_ += count;
+    if (buffer_size_ > capacity) {
+        buffer_head_ = (buffer_head_ + buffer_size_ - capacity) % capacity;
+        buffer_size_ = capacity;
     }
 }
 
 std::vector<float> AudioStreamer::getBufferedAudio() {
+    // allocate before locking so the callback never waits on the heap
+    std::vector<float> result;
+    result.reserve(buffer_.size());
     std::lock_guard<std::mutex> lock(buffer_mutex_);
-    std::vector<float> result = buffer_;
-    std::cout << "C++ buffer val 1 before clear:" << buffer_[1] << "\n";
-    buffer_.clear();  // Clear once fetched
-    //std::cout << "C++ buffer val 1 after clear:" << buffer_[1] << "\n";
+    const size_t first = std::min(buffer_size_, buffer_.size() - buffer_head_);
+    result.insert(result.end(), buffer_.begin() + buffer_head_, buffer_.begin() + buffer_head_ + first);
+    result.insert(result.end(), buffer_.begin(), buffer_.begin() + (buffer_size_ - first));
+    buffer_head_ = 0;
+    buffer_size_ = 0;  // cleared once fetched
     return result;
 }
 
 void AudioStreamer::flushBuffer() {
     std::lock_guard<std::mutex> lock(buffer_mutex_);
-    buffer_.clear();
-}
\ No newline at end of file
+    buffer_head_ = 0;
+    buffer_size_ = 0;
+}
+
+StreamStats AudioStreamer::stats() const {
+    StreamStats s;
+    s.callbacks = callbacks_;
+    s.frames = frames_;
+    s.xruns = xruns_;
+    if (engine_) {
+        s.dropped_samples = engine_->droppedSamples();
+        s.dropped_frames = engine_->droppedFrames();
+    }
+    return s;
+}
+
+void AudioStreamer::enableFeatures(const FeatureEngineConfig& config) {
+    // the callback reads engine_ without a lock, so only swap it while stopped
+    if (running_) throw std::runtime_error("Stop the stream before changing the feature engine");
+    engine_.reset(new StreamFeatureEngine(sample_rate_, config));
+}
+
+void AudioStreamer::disableFeatures() {
+    if (running_) throw std::runtime_error("Stop the stream before changing the feature engine");
+    engine_.reset();
+}
+
+bool AudioStreamer::featuresEnabled() const {
+    return engine_ != nullptr;
+}
+
+std::vector<FeatureFrame> AudioStreamer::getFeatureFrames() {
+    if (!engine_) return {};
+    return engine_->drain();
+}
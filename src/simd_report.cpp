@@ -0,0 +1,96 @@
+// Runtime SIMD capability report, see simd_report.hpp
+
+#include <simd_report.hpp>
+#include <fft_stft.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+
+#ifndef AUDIO_FEATURES_FFTW_SIMD
+#define AUDIO_FEATURES_FFTW_SIMD ""  // system FFTW, build options unknown
+#endif
+
+namespace {
+
+std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> out;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+std::vector<std::string> cpu_features() {
+    std::vector<std::string> out;
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    // libgcc's checks include OS support (XGETBV) for the AVX register state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) out.push_back("sse2");
+    if (__builtin_cpu_supports("avx")) out.push_back("avx");
+    if (__builtin_cpu_supports("avx2")) out.push_back("avx2");
+    if (__builtin_cpu_supports("fma")) out.push_back("fma");
+    if (__builtin_cpu_supports("avx512f")) out.push_back("avx512f");
+#endif
+    return out;
+}
+
+// codelet names end in their ISA: n1fv_16_avx2, hc2cfdftv_8_avx2_128, r2cf_32 (scalar) ...
+std::string codelet_isa(const std::string& word) {
+    static const char* isas[] = {"avx512", "avx2_128", "avx_128_fma", "avx2", "avx", "sse2"};
+    for (const char* isa : isas) {
+        std::string suffix = std::string("_") + isa;
+        if (word.size() > suffix.size() && word.compare(word.size() - suffix.size(), suffix.size(), suffix) == 0)
+            return isa;
+    }
+    return "";
+}
+
+void collect_isas(const std::string& plan, std::vector<std::string>& active) {
+    std::string word;
+    for (size_t i = 0; i <= plan.size(); ++i) {
+        char c = i < plan.size() ? plan[i] : ' ';
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+            word += c;
+            continue;
+        }
+        std::string isa = codelet_isa(word);
+        if (!isa.empty() && std::find(active.begin(), active.end(), isa) == active.end()) active.push_back(isa);
+        word.clear();
+    }
+}
+
+std::string plan_text(fftw_plan plan) {
+    char* text = fftw_sprint_plan(plan);
+    std::string out = text ? text : "";
+    std::free(text);
+    return out;
+}
+
+} // namespace
+
+SimdReport simd_report(int n_fft) {
+    SimdReport report;
+    report.fftw_version = fftw_version;
+    report.cpu = cpu_features();
+    report.built = split_list(AUDIO_FEATURES_FFTW_SIMD);
+
+    const int n = std::max(n_fft, 2);
+    double* real = fftw_alloc_real(n);
+    fftw_complex* spec = fftw_alloc_complex(n / 2 + 1);
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+        fftw_plan forward = fftw_plan_dft_r2c_1d(n, real, spec, FFTW_ESTIMATE);
+        fftw_plan inverse = fftw_plan_dft_c2r_1d(n, spec, real, FFTW_ESTIMATE);
+        report.plan = plan_text(forward);
+        collect_isas(report.plan, report.active);
+        collect_isas(plan_text(inverse), report.active);
+        fftw_destroy_plan(forward);
+        fftw_destroy_plan(inverse);
+    }
+    fftw_free(real);
+    fftw_free(spec);
+    return report;
+}
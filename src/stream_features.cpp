@@ -0,0 +1,219 @@
+// Real-time streaming feature engine
+// the capture callback pushes mono samples into a lock-free ring buffer, the worker thread below
+// wakes every hop and computes RMS, ZCR, spectral centroid and MFCCs for the newest window.
+// All analysis buffers, the FFT plan, the mel filterbank and the DCT table are built once
+// in the constructor so the per-hop path does not allocate (checked by test_allocations).
+
+#include <stream_features.hpp>
+#include <time_features.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+StreamFeatureEngine::StreamFeatureEngine(int sample_rate, const FeatureEngineConfig& config)
+    : sample_rate_(sample_rate),
+      config_(config),
+      last_push_ns_(0),
+      dropped_samples_(0),
+      pushed_(0),
+      lossless_(false),
+      running_(false),
+      frame_fill_(0),
+      next_index_(0),
+      queue_head_(0),
+      queue_size_(0),
+      published_(0),
+      dropped_frames_(0) {
+    if (config_.win_len <= 0 || config_.hop_len <= 0 || config_.hop_len > config_.win_len)
+        throw std::invalid_argument("hop_len must be in (0, win_len]");
+    if (config_.n_mel <= 0 || config_.n_mfcc <= 0 || config_.n_mfcc > config_.n_mel)
+        throw std::invalid_argument("n_mfcc must be in (0, n_mel]");
+    if (config_.queue_frames == 0)
+        throw std::invalid_argument("queue_frames must be positive");
+
+    int win_len = config_.win_len;
+
+    // keep at least a second of audio (or a few windows) between the callback and the worker
+    input_.reset(std::max<size_t>(sample_rate_, 4 * win_len));
+
+    spectrum_.reset(new SpectrumProcessor(win_len, win_len, config_.window));
+    mfcc_.reset(new MfccProcessor(sample_rate_, win_len, config_.n_mel, config_.n_mfcc));
+    frame_.assign(win_len, 0.0f);
+    magnitude_.assign(spectrum_->bins(), 0.0);
+
+    current_.mfcc.assign(config_.n_mfcc, 0.0);
+    slots_.assign(config_.queue_frames, current_);
+}
+
+StreamFeatureEngine::~StreamFeatureEngine() {
+    stop();
+}
+
+void StreamFeatureEngine::start() {
+    if (running_) return;
+    running_ = true;
+    worker_ = std::thread(&StreamFeatureEngine::run, this);
+}
+
+void StreamFeatureEngine::stop() {
+    if (!running_) return;
+    {
+        // under the queue lock so a worker waiting in publish() cannot miss it
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    wake_.notify_one();
+    slot_free_.notify_one();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool StreamFeatureEngine::isRunning() const {
+    return running_;
+}
+
+void StreamFeatureEngine::push(const float* mono, size_t count) {
+    size_t written = input_.push(mono, count);
+    pushed_ += written;
+    if (written < count) dropped_samples_ += count - written;
+    last_push_ns_.store(now_ns(), std::memory_order_relaxed);
+    // notify without the mutex, a missed wakeup is bounded by the wait timeout in run()
+    wake_.notify_one();
+}
+
+std::vector<FeatureFrame> StreamFeatureEngine::drain() {
+    std::vector<FeatureFrame> frames;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        frames.reserve(queue_size_);
+        for (size_t i = 0; i < queue_size_; ++i)
+            frames.push_back(slots_[(queue_head_ + i) % slots_.size()]);
+        queue_head_ = 0;
+        queue_size_ = 0;
+    }
+    slot_free_.notify_one();
+    return frames;
+}
+
+bool StreamFeatureEngine::waitForSpace(size_t count, std::chrono::milliseconds timeout) {
+    count = std::min(count, input_.capacity());
+    // the worker frees space without the lock, a missed wakeup costs at most the timeout
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    return progress_.wait_for(lock, timeout, [&] { return input_.capacity() - input_.available() >= count; });
+}
+
+bool StreamFeatureEngine::waitUntilProcessed(std::chrono::milliseconds timeout) {
+    const int64_t pushed = static_cast<int64_t>(pushed_.load());
+    const int64_t frames = pushed < config_.win_len ? 0 : (pushed - config_.win_len) / config_.hop_len + 1;
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    return progress_.wait_for(lock, timeout, [&] { return published_ >= frames; });
+}
+
+void StreamFeatureEngine::reset() {
+    bool was_running = running_;
+    stop();
+
+    input_.clear();
+    std::fill(frame_.begin(), frame_.end(), 0.0f);
+    frame_fill_ = 0;
+    next_index_ = 0;
+    pushed_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_head_ = 0;
+        queue_size_ = 0;
+        published_ = 0;
+    }
+
+    if (was_running) start();
+}
+
+void StreamFeatureEngine::run() {
+    const int hop_len = config_.hop_len;
+    const auto hop_period = std::chrono::microseconds(
+        static_cast<int64_t>(1e6 * hop_len / sample_rate_));
+
+    while (running_) {
+        size_t needed = frame_fill_ < (size_t)config_.win_len ? config_.win_len - frame_fill_ : hop_len;
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(lock, hop_period, [&] {
+                return !running_ || input_.available() >= needed;
+            });
+        }
+        processAvailable();
+    }
+
+    // samples that arrived before stop() still become frames
+    processAvailable();
+}
+
+// process every complete hop that is already buffered
+void StreamFeatureEngine::processAvailable() {
+    const int win_len = config_.win_len;
+    const int hop_len = config_.hop_len;
+
+    for (;;) {
+        if (frame_fill_ < (size_t)win_len) {
+            // first window: fill the frame before emitting anything
+            frame_fill_ += input_.pop(frame_.data() + frame_fill_, win_len - frame_fill_);
+            if (frame_fill_ < (size_t)win_len) break;
+        } else {
+            if (input_.available() < (size_t)hop_len) break;
+            std::copy(frame_.begin() + hop_len, frame_.end(), frame_.begin());
+            input_.pop(frame_.data() + (win_len - hop_len), hop_len);
+        }
+        processFrame();
+        publish();
+    }
+}
+
+void StreamFeatureEngine::processFrame() {
+    AF_TRACE_SCOPE("stream_frame");
+    const int win_len = config_.win_len;
+    const int n_bins = spectrum_->bins();
+
+    current_.index = next_index_;
+    current_.timestamp = static_cast<double>(next_index_) * config_.hop_len / sample_rate_;
+    ++next_index_;
+
+    current_.rms = calc_rms(frame_.data(), win_len);
+    current_.zcr = calc_zcr(frame_.data(), win_len);
+
+    spectrum_->magnitude(frame_.data(), magnitude_.data());
+
+    current_.centroid = spectral_centroid(magnitude_.data(), n_bins, static_cast<double>(sample_rate_) / win_len);
+
+    mfcc_->compute(magnitude_.data(), current_.mfcc.data());
+
+    current_.latency = (now_ns() - last_push_ns_.load(std::memory_order_relaxed)) * 1e-9;
+}
+
+void StreamFeatureEngine::publish() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    size_t capacity = slots_.size();
+    // lossless: wait for Python to drain; once stopped, fall through to overwriting like the live path
+    if (lossless_) slot_free_.wait(lock, [&] { return queue_size_ < capacity || !running_; });
+    if (queue_size_ == capacity) {
+        // Python is not keeping up, overwrite the oldest frame
+        queue_head_ = (queue_head_ + 1) % capacity;
+        --queue_size_;
+        ++dropped_frames_;
+    }
+    // slot vectors are already n_mfcc long, so this copy reuses their storage
+    slots_[(queue_head_ + queue_size_) % capacity] = current_;
+    ++queue_size_;
+    ++published_;
+    lock.unlock();
+    progress_.notify_one();
+}
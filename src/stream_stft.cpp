@@ -0,0 +1,210 @@
+// Incremental STFT, see stream_stft.hpp
+// the stream is framed without centering; when centered the n_fft / 2 padding samples are fed in as part of it
+// (left once the first n_fft / 2 + 1 samples are known, right at flush), exactly the samples compute_stft
+// reads virtually. A frame from the carry is windowed from doubles, one inside a block from the block's own
+// samples: float * double window gives the same product either way, so the spectra match batch bit for bit.
+
+#include <stream_stft.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// the spectra of the frames, one row of out after another
+class SpectrumRows : public StreamingStft::FrameSink {
+public:
+    SpectrumRows(SpectrumProcessor& spectrum, SpectrumType type, size_t row, double* out)
+        : spectrum_(spectrum), type_(type), row_(row), out_(out) {}
+    void frame(const float* samples) override { spectrum_.compute(samples, type_, next()); }
+    void frame(const double* samples) override { spectrum_.compute(samples, type_, next()); }
+
+private:
+    double* next() {
+        double* row = out_;
+        out_ += row_;
+        return row;
+    }
+
+    SpectrumProcessor& spectrum_;
+    SpectrumType type_;
+    size_t row_;
+    double* out_;
+};
+
+} // namespace
+
+StreamingStft::StreamingStft(int win_len, int hop_len, int n_fft, bool center, PadMode pad_mode,
+                             const WindowSpec& window, SpectrumType spectrum)
+    : hop_len_(hop_len),
+      center_(center),
+      pad_mode_(pad_mode),
+      type_(spectrum),
+      spectrum_(std::max(win_len, 1), n_fft > win_len ? n_fft : 0, window),
+      pad_(center ? spectrum_.fftSize() / 2 : 0),
+      carry_(spectrum_.fftSize()),
+      fill_(0),
+      skip_(0),
+      frame_(spectrum_.fftSize()),
+      head_(center ? pad_ + 1 : 0),
+      tail_(center ? pad_ + 1 : 0),
+      padding_(pad_),
+      padded_left_(false),
+      frames_(0),
+      samples_(0) {
+    if (win_len <= 0 || hop_len <= 0 || (n_fft > 0 && n_fft < win_len))
+        throw std::invalid_argument("need win_len > 0, hop_len > 0 and n_fft >= win_len");
+}
+
+void StreamingStft::reset() {
+    fill_ = 0;
+    skip_ = 0;
+    padded_left_ = false;
+    frames_ = 0;
+    samples_ = 0;
+}
+
+// frames feed() completes when n more (unpadded) stream samples arrive
+int StreamingStft::framesAfter(size_t n) const {
+    const size_t available = fill_ + (n > skip_ ? n - skip_ : 0);
+    const size_t frame = static_cast<size_t>(fftSize());
+    return available < frame ? 0 : static_cast<int>((available - frame) / hop_len_ + 1);
+}
+
+int StreamingStft::numFrames(size_t n) const {
+    if (center_ && !padded_left_) {
+        if (static_cast<size_t>(samples_) + n < head_.size()) return 0;
+        return framesAfter(pad_ + static_cast<size_t>(samples_) + n);
+    }
+    return framesAfter(n);
+}
+
+int StreamingStft::flushFrames() const {
+    if (!center_ || samples_ == 0) return 0;
+    return framesAfter(padded_left_ ? pad_ : 2 * pad_ + static_cast<size_t>(samples_));
+}
+
+// frames of the stream continued by samples[0, n): first those starting in the carry, then those inside the
+// block, then the start of the next frame becomes the carry
+template <typename T>
+int StreamingStft::feed(const T* samples, size_t n, FrameSink& sink) {
+    const size_t frame = static_cast<size_t>(fftSize());
+    const size_t hop = static_cast<size_t>(hop_len_);
+    int frames = 0;
+    size_t pos = std::min(skip_, n);
+    skip_ -= pos;
+    while (fill_ > 0 && fill_ + (n - pos) >= frame) {
+        std::copy(carry_.begin(), carry_.begin() + fill_, frame_.begin());
+        std::copy(samples + pos, samples + pos + (frame - fill_), frame_.begin() + fill_);
+        sink.frame(frame_.data());
+        ++frames;
+        if (hop < fill_) {
+            std::copy(carry_.begin() + hop, carry_.begin() + fill_, carry_.begin());
+            fill_ -= hop;
+        } else {
+            pos += hop - fill_;
+            fill_ = 0;
+        }
+    }
+    if (fill_ == 0) {
+        for (; pos + frame <= n; pos += hop, ++frames)
+            sink.frame(samples + pos);
+        if (pos > n) {
+            skip_ = pos - n;
+            pos = n;
+        }
+    }
+    std::copy(samples + pos, samples + n, carry_.begin() + fill_);
+    fill_ += n - pos;
+    frames_ += frames;
+    return frames;
+}
+
+// the latest tail_.size() samples, right-aligned (fewer are valid while samples_ is smaller)
+void StreamingStft::remember(const double* samples, size_t n) {
+    const size_t keep = tail_.size();
+    if (n >= keep) {
+        std::copy(samples + n - keep, samples + n, tail_.begin());
+        return;
+    }
+    std::copy(tail_.begin() + n, tail_.end(), tail_.begin());
+    std::copy(samples, samples + n, tail_.end() - n);
+}
+
+// left padding from the head (all of the signal when it is shorter), then the head itself
+int StreamingStft::padLeft(FrameSink& sink) {
+    const size_t real = std::min(static_cast<size_t>(samples_), head_.size());
+    for (int i = 0; i < pad_; ++i) {
+        const long j = pad_index(i - pad_, real, pad_mode_);
+        padding_[i] = j < 0 ? 0.0 : head_[j];
+    }
+    padded_left_ = true;
+    const int frames = feed(padding_.data(), padding_.size(), sink);
+    return frames + feed(head_.data(), real, sink);
+}
+
+template <typename T>
+int StreamingStft::pushSamples(const T* samples, size_t n, FrameSink& sink) {
+    AF_TRACE_SCOPE("stream_stft");
+    int frames = 0;
+    if (center_) {
+        // tail_ is refilled from doubles; the block itself may be float
+        for (size_t done = 0; done < n;) {
+            const size_t count = std::min(n - done, frame_.size());
+            std::copy(samples + done, samples + done + count, frame_.begin());
+            remember(frame_.data(), count);
+            done += count;
+        }
+        if (!padded_left_) {
+            const size_t have = static_cast<size_t>(samples_);
+            const size_t take = std::min(n, head_.size() - have);
+            std::copy(samples, samples + take, head_.begin() + have);
+            samples_ += take;
+            if (have + take < head_.size()) return 0;
+            frames = padLeft(sink);
+            samples += take;
+            n -= take;
+        }
+    }
+    samples_ += n;
+    return frames + feed(samples, n, sink);
+}
+
+int StreamingStft::push(const float* samples, size_t n, double* out) {
+    SpectrumRows rows(spectrum_, type_, rowSize(), out);
+    return pushSamples(samples, n, rows);
+}
+
+int StreamingStft::push(const double* samples, size_t n, double* out) {
+    SpectrumRows rows(spectrum_, type_, rowSize(), out);
+    return pushSamples(samples, n, rows);
+}
+
+int StreamingStft::flush(double* out) {
+    SpectrumRows rows(spectrum_, type_, rowSize(), out);
+    return flush(rows);
+}
+
+int StreamingStft::push(const float* samples, size_t n, FrameSink& sink) {
+    return pushSamples(samples, n, sink);
+}
+
+int StreamingStft::push(const double* samples, size_t n, FrameSink& sink) {
+    return pushSamples(samples, n, sink);
+}
+
+int StreamingStft::flush(FrameSink& sink) {
+    int frames = 0;
+    if (center_ && samples_ > 0) {
+        if (!padded_left_) frames = padLeft(sink);  // stream shorter than the padding
+        const size_t keep = tail_.size();
+        const long real = static_cast<long>(samples_);
+        for (int i = 0; i < pad_; ++i) {
+            const long j = pad_index(real + i, static_cast<size_t>(real), pad_mode_);
+            padding_[i] = j < 0 ? 0.0 : tail_[keep - static_cast<size_t>(real - j)];
+        }
+        frames += feed(padding_.data(), padding_.size(), sink);
+    }
+    reset();
+    return frames;
+}
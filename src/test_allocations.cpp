@@ -0,0 +1,217 @@
+/**
+ * Zero-allocation checks for the steady-state hot paths
+ * once the per-frame kernels (SpectrumProcessor, MfccProcessor) and the streaming engine are constructed,
+ * processing another frame must not touch the heap. Links src/alloc_counter.cpp to count operator new.
+ *
+ * BUILD / RUN (CMake target, also registered with ctest)
+ *   cmake --build build --target test_allocations
+ *   ./build/test_allocations      # or: ctest --test-dir build
+ *
+ * The caller-buffer compute_stft / centroid / rolloff / compute_mfcc / compute_log_mel and StreamingStft::push
+ * must not allocate either once their thread's kernels exist. Also prints the whole-call allocation counts of the
+ * vector-returning versions for reference (those return nested vectors, so they allocate once per output row,
+ * not per intermediate). Invalid STFT settings must throw std::invalid_argument from every STFT entry point.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <alloc_counter.hpp>
+#include <fft_stft.hpp>
+#include <log_mel.hpp>
+#include <stream_features.hpp>
+#include <stream_stft.hpp>
+
+namespace {
+
+int g_failures = 0;
+
+void check_zero(const char* name, const AllocStats& s, long frames) {
+    bool ok = s.allocs == 0 && s.frees == 0;
+    std::printf("%-28s %s  frames=%ld allocs=%llu frees=%llu bytes=%llu\n", name, ok ? "ok  " : "FAIL", frames,
+                (unsigned long long)s.allocs, (unsigned long long)s.frees, (unsigned long long)s.bytes);
+    if (!ok) ++g_failures;
+}
+
+AllocStats diff(const AllocStats& a, const AllocStats& b) {
+    AllocStats d;
+    d.allocs = b.allocs - a.allocs;
+    d.frees = b.frees - a.frees;
+    d.bytes = b.bytes - a.bytes;
+    return d;
+}
+
+std::vector<float> make_signal(int sample_rate, double seconds) {
+    std::vector<float> sig(static_cast<size_t>(sample_rate * seconds));
+    for (size_t i = 0; i < sig.size(); ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        sig[i] = 0.5f * std::sin(2 * M_PI * 440.0 * t) + 0.1f * std::sin(2 * M_PI * 5000.0 * t);
+    }
+    return sig;
+}
+
+} // namespace
+
+int main() {
+    const int sample_rate = 16000;
+    const int win_len = 1024;
+    const int hop_len = 256;
+    std::vector<float> sig = make_signal(sample_rate, 2.0);
+    std::vector<double> sig_d(sig.begin(), sig.end());
+    const long frames = static_cast<long>((sig.size() - win_len) / hop_len + 1);
+
+    SpectrumProcessor spectrum(win_len);
+    MfccProcessor mfcc(sample_rate, win_len);
+    std::vector<double> magnitude(spectrum.bins());
+    std::vector<double> coeffs(mfcc.numMfcc());
+
+    // STFT frame kernel, double and float input
+    {
+        AllocScope scope;
+        for (long f = 0; f < frames; ++f)
+            spectrum.magnitude(sig_d.data() + f * hop_len, magnitude.data());
+        check_zero("SpectrumProcessor (double)", scope.stats(), frames);
+    }
+    {
+        AllocScope scope;
+        for (long f = 0; f < frames; ++f)
+            spectrum.magnitude(sig.data() + f * hop_len, magnitude.data());
+        check_zero("SpectrumProcessor (float)", scope.stats(), frames);
+    }
+
+    // MFCC frame kernel
+    {
+        AllocScope scope;
+        for (long f = 0; f < frames; ++f) {
+            spectrum.magnitude(sig_d.data() + f * hop_len, magnitude.data());
+            mfcc.compute(magnitude.data(), coeffs.data());
+        }
+        check_zero("MfccProcessor", scope.stats(), frames);
+    }
+
+    // streaming engine: the worker thread allocates nothing per hop, measured with the global counters
+    // (queue sized to hold every frame so nothing is drained until the end)
+    {
+        FeatureEngineConfig config;
+        config.win_len = win_len;
+        config.hop_len = hop_len;
+        config.queue_frames = static_cast<size_t>(frames) + 1;
+        StreamFeatureEngine engine(sample_rate, config);
+        engine.start();
+
+        const size_t block = 512;
+        size_t pos = 0;
+        // warm up: first window and a few hops
+        for (; pos + block <= 4 * static_cast<size_t>(win_len); pos += block)
+            engine.push(sig.data() + pos, block);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        AllocStats before = alloc_stats_global();
+        for (; pos + block <= sig.size(); pos += block) {
+            engine.push(sig.data() + pos, block);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        // let the worker catch up; stop() is left out of the window since joining frees the thread state
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        AllocStats after = alloc_stats_global();
+        engine.stop();
+
+        std::vector<FeatureFrame> out = engine.drain();
+        long expected = static_cast<long>((pos - win_len) / hop_len + 1);
+        check_zero("StreamFeatureEngine", diff(before, after), static_cast<long>(out.size()));
+        if (static_cast<long>(out.size()) != expected || engine.droppedSamples() || engine.droppedFrames()) {
+            std::printf("StreamFeatureEngine          FAIL  expected %ld frames, got %zu (dropped %llu samples, %llu frames)\n",
+                        expected, out.size(), (unsigned long long)engine.droppedSamples(),
+                        (unsigned long long)engine.droppedFrames());
+            ++g_failures;
+        }
+    }
+
+    // caller-buffer entry points: the first call builds this thread's kernels, repeats allocate nothing
+    {
+        const int bins = win_len / 2 + 1;
+        const int n_frames = stft_num_frames(sig.size(), win_len, hop_len, win_len, true);
+        std::vector<double> stft(static_cast<size_t>(n_frames) * bins);
+        std::vector<double> centroid(n_frames), rolloff(n_frames), coeffs(static_cast<size_t>(n_frames) * 13);
+        std::vector<uint16_t> log_mel(static_cast<size_t>(n_frames) * 64);
+        auto run = [&] {
+            compute_stft(sig.data(), sig.size(), win_len, hop_len, win_len, true, PadMode::Reflect, WindowSpec(),
+                         SpectrumType::Magnitude, stft.data());
+            compute_spectral_centroid(stft.data(), n_frames, bins, sample_rate, win_len, centroid.data());
+            compute_spectral_rolloff(stft.data(), n_frames, bins, sample_rate, win_len, 0.99, rolloff.data());
+            compute_mfcc(stft.data(), n_frames, sample_rate, win_len, 26, 13, SpectrumType::Magnitude, coeffs.data());
+            compute_log_mel(stft.data(), n_frames, sample_rate, win_len, 64, SpectrumType::Magnitude,
+                            LogMelDtype::Float16, true, log_mel.data());
+        };
+        run();
+        AllocScope scope;
+        for (int i = 0; i < 3; ++i) run();
+        check_zero("compute_* (out buffers)", scope.stats(), 3L * n_frames);
+    }
+
+    // streaming STFT: blocks straddling frames go through the carry, flush pads the end; no allocation either
+    {
+        StreamingStft stream(win_len, hop_len, win_len, true, PadMode::Reflect);
+        const int n_frames = stft_num_frames(sig.size(), win_len, hop_len, win_len, true);
+        std::vector<double> stft(static_cast<size_t>(n_frames) * stream.rowSize());
+        const size_t block = 300;
+        AllocScope scope;
+        int written = 0;
+        for (size_t pos = 0; pos < sig.size(); pos += block)
+            written += stream.push(sig.data() + pos, std::min(block, sig.size() - pos),
+                                   stft.data() + static_cast<size_t>(written) * stream.rowSize());
+        written += stream.flush(stft.data() + static_cast<size_t>(written) * stream.rowSize());
+        check_zero("StreamingStft", scope.stats(), written);
+        if (written != n_frames) {
+            std::printf("StreamingStft                FAIL  expected %d frames, got %d\n", n_frames, written);
+            ++g_failures;
+        }
+    }
+
+    // batch entry points, informational
+    {
+        AllocScope scope;
+        std::vector<std::vector<double>> stft = compute_stft(sig_d, win_len, hop_len);
+        AllocStats s = scope.stats();
+        std::printf("%-28s info  frames=%zu allocs=%llu bytes=%llu\n", "compute_stft", stft.size(),
+                    (unsigned long long)s.allocs, (unsigned long long)s.bytes);
+
+        AllocScope mfcc_scope;
+        std::vector<std::vector<double>> m = compute_mfcc(stft, sample_rate, win_len, 26, 13);
+        s = mfcc_scope.stats();
+        std::printf("%-28s info  frames=%zu allocs=%llu bytes=%llu\n", "compute_mfcc", m.size(),
+                    (unsigned long long)s.allocs, (unsigned long long)s.bytes);
+    }
+
+    // settings no STFT can frame are rejected by every entry point, not answered with an empty result
+    {
+        const int bad[][3] = {{0, hop_len, 0}, {win_len, 0, 0}, {win_len, hop_len, win_len / 2}};
+        for (const auto& p : bad) {
+            const int entry_points = 3;
+            int thrown = 0;
+            try { stft_num_frames(sig.size(), p[0], p[1], p[2]); } catch (const std::invalid_argument&) { ++thrown; }
+            try { compute_stft(sig_d, p[0], p[1], p[2]); } catch (const std::invalid_argument&) { ++thrown; }
+            try {
+                double out = 0.0;
+                compute_stft(sig.data(), sig.size(), p[0], p[1], p[2], false, PadMode::Constant, WindowSpec(),
+                             SpectrumType::Magnitude, &out);
+            } catch (const std::invalid_argument&) { ++thrown; }
+            if (thrown != entry_points) {
+                std::printf("invalid STFT settings        FAIL  win_len=%d hop_len=%d n_fft=%d: %d of %d threw\n",
+                            p[0], p[1], p[2], thrown, entry_points);
+                ++g_failures;
+            }
+        }
+    }
+
+    if (g_failures) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("all allocation checks passed\n");
+    return 0;
+}
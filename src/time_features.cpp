@@ -0,0 +1,47 @@
+// Time-domain audio features (RMS and ZCR)
+// pointer versions are used per frame by the streaming engine, vector versions are exposed to python
+
+#include <cmath>
+#include <time_features.hpp>
+
+// audio feature functions (currently rms and zcr)
+float calc_rms(const float* sig, size_t N) {
+    float squares = 0.0;
+
+    for (size_t i = 0; i < N; ++i) {
+        squares += (sig[i] * sig[i]);
+    }
+    // Print statement for debugging
+    // std::cout << sqrt(squares/ static_cast<float>(N)) << std::endl;
+
+    return std::sqrt(squares / static_cast<float>(N));
+}
+
+float calc_rms(const std::vector<float>& sig) {
+    return calc_rms(sig.data(), sig.size());
+}
+
+float calc_zcr(const float* sig, size_t N) {
+    int zcr_count = 0;
+    int same_sign_count = 1;
+
+    for (size_t i = 1; i < N; ++i) { // start comparison at second sig to compare to first
+        int current_sign = (sig[i] > 0) - (sig[i] < 0);
+        int prev_sign = (sig[i - same_sign_count] > 0) - (sig[i - same_sign_count] < 0);
+
+        if (current_sign == 0 || current_sign == prev_sign) {
+            same_sign_count++;
+        } else {
+            zcr_count++;
+            same_sign_count = 1;
+        }
+    }
+    // Print statement for debugging
+    // std::cout << static_cast<float>(zcr_count) / N << std::endl;
+
+    return static_cast<float>(zcr_count) / N;
+}
+
+float calc_zcr(const std::vector<float>& sig) {
+    return calc_zcr(sig.data(), sig.size());
+}
@@ -0,0 +1,173 @@
+// Per-thread trace buffers and Chrome trace JSON export, see trace.hpp
+// each thread gets an event buffer on its first recorded span, grown in chunks as it records (so short-lived
+// pool workers cost what they record, not the full capacity); the registry keeps the buffers alive after
+// their thread exits so dump() still sees them, until clear() releases them.
+
+#include <trace.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+std::atomic<bool> g_enabled(false);
+
+namespace {
+
+// chunk c holds kFirstChunk << c events (24 bytes each), allocated by the recording thread when it needs it:
+// a worker that records a few spans costs 6 KB, a busy thread still gets about 1 << 18 events
+const size_t kFirstChunk = 256;
+const int kMaxChunks = 10;
+const size_t kBufferEvents = kFirstChunk * ((size_t(1) << kMaxChunks) - 1);
+
+// chunk holding event i, and i's position in it
+inline int chunk_of(size_t i, size_t& offset) {
+    int c = 0;
+    size_t start = 0;
+    while (i >= start + (kFirstChunk << c)) start += kFirstChunk << c++;
+    offset = i - start;
+    return c;
+}
+
+struct Event {
+    const char* name;
+    int64_t start_ns;
+    int64_t dur_ns;
+};
+
+struct ThreadBuffer {
+    explicit ThreadBuffer(int id) : tid(id), chunks(kMaxChunks), count(0), exited(false) {}
+    const Event& operator[](size_t i) const {
+        size_t offset;
+        const int c = chunk_of(i, offset);
+        return chunks[c][offset];
+    }
+    int tid;
+    // chunk pointers below count are fixed, only the owning thread sets the next one before publishing count
+    std::vector<std::unique_ptr<Event[]>> chunks;
+    std::atomic<size_t> count;  // written by the owning thread only, published with release
+    std::atomic<bool> exited;
+};
+
+// the thread's handle on its buffer, marks it exited (releasable by clear()) when the thread ends
+struct ThreadSlot {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~ThreadSlot() {
+        if (buffer) buffer->exited.store(true, std::memory_order_release);
+    }
+};
+
+std::mutex g_registry_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> g_registry;
+int g_next_tid = 1;
+std::atomic<uint64_t> g_dropped(0);
+const int64_t g_origin_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+
+ThreadBuffer* thread_buffer() {
+    thread_local ThreadSlot slot;
+    if (!slot.buffer) {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        slot.buffer = std::make_shared<ThreadBuffer>(g_next_tid++);
+        g_registry.push_back(slot.buffer);
+    }
+    return slot.buffer.get();
+}
+
+void write_escaped(FILE* f, const char* s) {
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+}
+
+} // namespace
+
+void enable(bool on) {
+    g_enabled.store(on, std::memory_order_relaxed);
+}
+
+bool enabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+bool compiled_in() {
+#ifdef AUDIO_FEATURES_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void clear() {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    // buffers of finished threads are freed, live threads keep their chunks for the next spans
+    g_registry.erase(std::remove_if(g_registry.begin(), g_registry.end(),
+                                    [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                                        return buffer->exited.load(std::memory_order_acquire);
+                                    }),
+                     g_registry.end());
+    for (const std::shared_ptr<ThreadBuffer>& buffer : g_registry)
+        buffer->count.store(0, std::memory_order_release);
+    g_dropped = 0;
+}
+
+uint64_t dropped() {
+    return g_dropped;
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() - g_origin_ns;
+}
+
+void record(const char* name, int64_t start_ns, int64_t end_ns) {
+    ThreadBuffer* buffer = thread_buffer();
+    size_t n = buffer->count.load(std::memory_order_relaxed);
+    if (n == kBufferEvents) {
+        ++g_dropped;
+        return;
+    }
+    size_t offset;
+    const int c = chunk_of(n, offset);
+    std::unique_ptr<Event[]>& chunk = buffer->chunks[c];
+    if (!chunk) chunk.reset(new Event[kFirstChunk << c]);
+    Event& e = chunk[offset];
+    e.name = name;
+    e.start_ns = start_ns;
+    e.dur_ns = end_ns - start_ns;
+    buffer->count.store(n + 1, std::memory_order_release);
+}
+
+bool dump(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    std::fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    bool first = true;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : g_registry) {
+        size_t n = buffer->count.load(std::memory_order_acquire);
+        if (n == 0) continue;
+        std::fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                        "\"args\": {\"name\": \"thread %d\"}}",
+                     first ? "" : ",\n", buffer->tid, buffer->tid);
+        first = false;
+        for (size_t i = 0; i < n; ++i) {
+            const Event& e = (*buffer)[i];
+            // complete events, timestamps in microseconds
+            std::fprintf(f, ",\n{\"name\": \"");
+            write_escaped(f, e.name);
+            std::fprintf(f, "\", \"cat\": \"audio_features\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                            "\"ts\": %.3f, \"dur\": %.3f}",
+                         buffer->tid, e.start_ns * 1e-3, e.dur_ns * 1e-3);
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+}
+
+} // namespace trace
@@ -0,0 +1,84 @@
+// WAV / libsndfile reading (shared by the Python module and the native tools)
+
+#include <sndfile.h>
+#include <iostream>
+#include <stdexcept>
+#include <wav_io.hpp>
+#include <trace.hpp>
+
+// get wave data from selected file and 
+std::pair<std::vector<float>, int> get_wav_data(std::string const wav_filename) {
+    AF_TRACE_SCOPE("decode");
+    // convert string soundfile name to char
+    const char* wav_filename_char = wav_filename.c_str();
+    
+    std::vector<float> signal_vector;
+    // valgrind fix zero-initialize
+    SF_INFO sfinfo = {0}; // zero out all fields
+    SNDFILE *file = sf_open(wav_filename_char, SFM_READ, &sfinfo);
+    int sample_rate = sfinfo.samplerate;
+
+    if (!file) {
+        std::cerr << "Failed to open file\n";
+        return std::make_pair(signal_vector, sample_rate);
+    }
+
+    std::vector<short> samples(sfinfo.frames * sfinfo.channels);
+    sf_readf_short(file, samples.data(), sfinfo.frames);
+    sf_close(file);
+
+    // DEBUGGING
+    // // Print size of vector
+    // std::cout << "Vector Size before cast: " << samples.size() << std::endl;
+
+    // // Print first 10 samples of std::vector<short>
+    // for (int i = 0; i < 10 && i < samples.size(); ++i) {
+    //     std::cout << "Short Sample[" << i << "] = " << samples[i] << "\n";
+    // }
+
+    // Convert short samples to float in range [-1.0, 1.0]
+    signal_vector.reserve(samples.size());
+    for (short s : samples) {
+        signal_vector.push_back(static_cast<float>(s) / 32768.0f);
+    }
+
+    // DEBUGGING    
+    // // Print first 10 samples of std::vector<float>
+    // for (int i = 0; i < 10 && i < samples.size(); ++i) {
+    //     std::cout << "Float Sample[" << i << "] = " << samples[i] << "\n";
+    // }
+
+    // // Print size of vector
+    // std::cout << "Vector Size just before return: " << samples.size() << std::endl;
+
+    return std::make_pair(signal_vector, sample_rate);
+}
+
+bool get_wav_info(const std::string& wav_filename, WavFileInfo& info) {
+    SF_INFO sfinfo = {0};
+    SNDFILE* file = sf_open(wav_filename.c_str(), SFM_READ, &sfinfo);
+    if (!file) return false;
+    sf_close(file);
+
+    info.frames = sfinfo.frames;
+    info.sample_rate = sfinfo.samplerate;
+    info.channels = sfinfo.channels;
+    return true;
+}
+
+std::pair<std::vector<float>, int> get_wav_mono(const std::string& wav_filename) {
+    WavFileInfo info;
+    if (!get_wav_info(wav_filename, info) || info.channels < 1)
+        throw std::runtime_error("Cannot open " + wav_filename);
+    std::pair<std::vector<float>, int> wav = get_wav_data(wav_filename);
+    if (info.channels == 1) return wav;
+    const size_t n = wav.first.size() / info.channels;
+    std::vector<float> mono(n);
+    const float scale = 1.0f / info.channels;
+    for (size_t i = 0; i < n; ++i) {
+        float sum = 0.0f;
+        for (int c = 0; c < info.channels; ++c) sum += wav.first[i * info.channels + c];
+        mono[i] = sum * scale;
+    }
+    return std::make_pair(std::move(mono), wav.second);
+}
@@ -1,31 +1,222 @@
 #include "wav_player.h"  // Include the declaration of our function
-#include <cstdlib>       // For std::system()
+#include "portaudio_capture.hpp"  // PortAudioRuntime
+#include <sndfile.h>
 #include <iostream>      // For console output
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
-// This function plays a .wav file using system tools like aplay or afplay
-void play_wav_file(const std::string& filepath) {
-#if defined(__linux__)
-    // Linux: use 'aplay' to play the WAV file
-    std::string cmd = "aplay \"" + filepath + "\"";
-#elif defined(__APPLE__)
-    // macOS: use 'afplay' to play the WAV file
-    std::string cmd = "afplay \"" + filepath + "\"";
-#elif defined(_WIN32) || defined(_WIN64)
-    // Windows: use PowerShell to play the WAV file
-    std::string cmd = "powershell -c (New-Object Media.SoundPlayer \"" + filepath + "\").PlaySync();";
-#else
-    // If none of the OS macros match, we throw an error
-    throw std::runtime_error("Unsupported OS");
-#endif
+namespace {
+
+const int kDecodeBlockFrames = 2048;
+const uint64_t kNoEof = std::numeric_limits<uint64_t>::max();
+
+} // namespace
 
+// This function plays a .wav file in-process and blocks until playback ends
+void play_wav_file(const std::string& filepath) {
     // Print what file is being played
     std::cout << "Playing: " << filepath << std::endl;
 
-    // Execute the system command to play the file
-    int result = std::system(cmd.c_str());
+    WavPlayer player(filepath);
+    player.play();
+    while (player.isPlaying())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+
+WavPlayer::WavPlayer(const std::string& filepath)
+    : file_(nullptr),
+      stream_(nullptr),
+      sample_rate_(0),
+      channels_(0),
+      total_frames_(0),
+      closing_(false),
+      eof_gen_(kNoEof),
+      playing_(false),
+      stream_started_(false),
+      played_frames_(0),
+      seek_gen_(0),
+      seek_target_(0),
+      flush_gen_(0),
+      flushed_gen_(0) {
+    SF_INFO sfinfo = {0};
+    SNDFILE* file = sf_open(filepath.c_str(), SFM_READ, &sfinfo);
+    if (!file)
+        throw std::runtime_error("Failed to open WAV file: " + filepath);
+    file_ = file;
+    sample_rate_ = sfinfo.samplerate;
+    channels_ = sfinfo.channels;
+    total_frames_ = sfinfo.frames;
+
+    try {
+        portaudio_ = PortAudioRuntime::acquire();
+
+        PaDeviceIndex dev = Pa_GetDefaultOutputDevice();
+        const PaDeviceInfo* devInfo = dev == paNoDevice ? nullptr : Pa_GetDeviceInfo(dev);
+        if (!devInfo)
+            throw std::runtime_error("No default output device found");
+
+        PaStreamParameters outputParams;
+        outputParams.device = dev;
+        outputParams.channelCount = channels_;
+        outputParams.sampleFormat = paFloat32;
+        outputParams.suggestedLatency = devInfo->defaultLowOutputLatency;
+        outputParams.hostApiSpecificStreamInfo = nullptr;
+
+        PaError err = Pa_OpenStream(&stream_, nullptr, &outputParams, sample_rate_,
+                                    paFramesPerBufferUnspecified, paClipOff,
+                                    &WavPlayer::streamCallback, this);
+        if (err != paNoError) {
+            stream_ = nullptr;
+            throw std::runtime_error(std::string("Failed to open output stream: ") + Pa_GetErrorText(err));
+        }
+    } catch (...) {
+        sf_close(file);
+        throw;
+    }
+
+    // half a second of decoded audio between the decoder and the device, and never less than two decode
+    // blocks: the decoder only reads when a whole block fits, so a smaller ring would never refill
+    const size_t ring_frames = std::max<size_t>(static_cast<size_t>(sample_rate_ / 2), 2 * kDecodeBlockFrames);
+    ring_.reset(ring_frames * channels_);
+    decoder_ = std::thread(&WavPlayer::decodeLoop, this);
+}
+
+WavPlayer::~WavPlayer() {
+    close();
+}
+
+void WavPlayer::play() {
+    if (closing_) throw std::runtime_error("Player is closed");
+
+    // play after the end of the file starts over
+    if (eof_gen_ == seek_gen_ && ring_.available() == 0) seek(0.0);
+
+    playing_ = true;
+    if (!stream_started_) {
+        PaError err = Pa_StartStream(stream_);
+        if (err != paNoError) {
+            playing_ = false;
+            throw std::runtime_error(std::string("Failed to start output stream: ") + Pa_GetErrorText(err));
+        }
+        stream_started_ = true;
+    }
+}
+
+void WavPlayer::pause() {
+    playing_ = false;
+}
+
+void WavPlayer::stop() {
+    playing_ = false;
+    seek(0.0);
+}
+
+void WavPlayer::seek(double seconds) {
+    int64_t target = static_cast<int64_t>(seconds * sample_rate_);
+    target = std::max<int64_t>(0, std::min<int64_t>(target, total_frames_));
+
+    seek_target_ = target;
+    played_frames_ = target;  // report the new position right away
+    ++seek_gen_;
+    decoder_wake_.notify_one();
+}
+
+void WavPlayer::close() {
+    if (closing_.exchange(true)) return;
+
+    playing_ = false;
+    decoder_wake_.notify_one();
+    if (decoder_.joinable()) decoder_.join();
+
+    if (stream_) {
+        if (stream_started_) Pa_StopStream(stream_);
+        Pa_CloseStream(stream_);
+        stream_ = nullptr;
+    }
+    if (file_) {
+        sf_close(static_cast<SNDFILE*>(file_));
+        file_ = nullptr;
+    }
+    portaudio_.reset();
+}
+
+bool WavPlayer::isPlaying() const {
+    return playing_;
+}
+
+double WavPlayer::position() const {
+    return static_cast<double>(played_frames_) / sample_rate_;
+}
+
+double WavPlayer::duration() const {
+    return static_cast<double>(total_frames_) / sample_rate_;
+}
+
+void WavPlayer::decodeLoop() {
+    SNDFILE* file = static_cast<SNDFILE*>(file_);
+    std::vector<float> block(static_cast<size_t>(kDecodeBlockFrames) * channels_);
+    uint64_t handled_gen = 0;
+
+    while (!closing_) {
+        uint64_t gen = seek_gen_;
+        if (gen != handled_gen) {
+            // nothing is pushed while the callback drops what was decoded before the seek
+            flush_gen_ = gen;
+            if (flushed_gen_ != gen) {
+                std::unique_lock<std::mutex> lock(decoder_mutex_);
+                decoder_wake_.wait_for(lock, std::chrono::milliseconds(5));
+                continue;
+            }
+            sf_seek(file, seek_target_, SEEK_SET);
+            handled_gen = gen;
+            continue;
+        }
+
+        size_t space = ring_.capacity() - ring_.available();
+        if (eof_gen_ == handled_gen || space < block.size()) {
+            std::unique_lock<std::mutex> lock(decoder_mutex_);
+            decoder_wake_.wait_for(lock, std::chrono::milliseconds(5));
+            continue;
+        }
+
+        sf_count_t n = sf_readf_float(file, block.data(), kDecodeBlockFrames);
+        if (n <= 0) {
+            eof_gen_ = handled_gen;
+            continue;
+        }
+        ring_.push(block.data(), static_cast<size_t>(n) * channels_);
+    }
+}
+
+int WavPlayer::streamCallback(const void*, void* outputBuffer, unsigned long framesPerBuffer,
+                              const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags, void* userData) {
+    static_cast<WavPlayer*>(userData)->renderOutput(static_cast<float*>(outputBuffer), framesPerBuffer);
+    return paContinue;
+}
+
+void WavPlayer::renderOutput(float* out, unsigned long frames) {
+    const size_t want = static_cast<size_t>(frames) * channels_;
+
+    // pending seek: drop everything decoded for the old position and let the decoder continue
+    uint64_t flush = flush_gen_;
+    if (flush != flushed_gen_) {
+        ring_.clear();
+        played_frames_ = seek_target_.load();
+        flushed_gen_ = flush;
+        decoder_wake_.notify_one();
+    }
+
+    size_t got = 0;
+    if (playing_) {
+        got = ring_.pop(out, want);
+        played_frames_ += got / channels_;
+        if (got > 0) decoder_wake_.notify_one();
 
-    // Check if the command failed (non-zero return)
-    if (result != 0) {
-        throw std::runtime_error("Failed to play WAV file.");
+        // end of file: everything decoded for the current position has been played
+        if (got < want && eof_gen_ == seek_gen_ && ring_.available() == 0)
+            playing_ = false;
     }
-}
\ No newline at end of file
+    std::fill(out + got, out + want, 0.0f);
+}
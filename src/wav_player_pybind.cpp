@@ -6,5 +6,21 @@ namespace py = pybind11; // Create a shortcut so we don't have to write pybind11
 // This macro creates a Python module named 'wav_player'
 PYBIND11_MODULE(wav_player, m) {
     // We add the C++ function 'play_wav_file' to the Python module
-    m.def("play_wav_file", &play_wav_file, "Play a WAV file from the given file path");
-}
\ No newline at end of file
+    // (blocks until playback ends, release the GIL so other Python threads keep running)
+    m.def("play_wav_file", &play_wav_file, py::call_guard<py::gil_scoped_release>(),
+          "Play a WAV file from the given file path");
+
+    // Non-blocking player: decoding and playback run on background threads
+    py::class_<WavPlayer>(m, "WavPlayer")
+        .def(py::init<const std::string&>(), py::arg("filepath"), "Open a WAV file on the default output device")
+        .def("play", &WavPlayer::play, "Start or resume playback")
+        .def("pause", &WavPlayer::pause, "Pause playback, keeping the position")
+        .def("stop", &WavPlayer::stop, "Stop playback and rewind to the start")
+        .def("seek", &WavPlayer::seek, py::arg("seconds"), "Jump to a position in seconds")
+        .def("close", &WavPlayer::close, py::call_guard<py::gil_scoped_release>(), "Release the device and file")
+        .def("is_playing", &WavPlayer::isPlaying)
+        .def_property_readonly("position", &WavPlayer::position, "Playback position in seconds")
+        .def_property_readonly("duration", &WavPlayer::duration, "File length in seconds")
+        .def_property_readonly("sample_rate", &WavPlayer::sampleRate)
+        .def_property_readonly("channels", &WavPlayer::channels);
+}
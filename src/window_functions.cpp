@@ -0,0 +1,129 @@
+// Window functions and their shared table cache, see window_functions.hpp
+// formulas follow scipy.signal.windows (symmetric uses length - 1 as the period, periodic uses length)
+
+#include <window_functions.hpp>
+#include <fftw3.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+// modified Bessel function of the first kind, order 0 (power series, converges quickly for beta < 50)
+double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double q = x * x / 4.0;
+    for (int k = 1; k < 500; ++k) {
+        term *= q / (static_cast<double>(k) * k);
+        sum += term;
+        if (term < sum * 1e-17) break;
+    }
+    return sum;
+}
+
+// sum of cosines a0 - a1 cos(x) + a2 cos(2x) - ...
+double cosine_sum(const double* a, int terms, double x) {
+    double value = 0.0;
+    for (int k = 0; k < terms; ++k)
+        value += (k % 2 ? -a[k] : a[k]) * std::cos(k * x);
+    return value;
+}
+
+void fill_window(const WindowSpec& spec, int length, double* out) {
+    static const double kHamming[] = {0.54, 0.46};
+    static const double kBlackman[] = {0.42, 0.5, 0.08};
+    static const double kBlackmanHarris[] = {0.35875, 0.48829, 0.14128, 0.01168};
+    static const double kFlatTop[] = {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+
+    if (length == 1) {
+        out[0] = 1.0;
+        return;
+    }
+    const int period = spec.periodic ? length : length - 1;
+
+    for (int n = 0; n < length; ++n) {
+        double x = 2 * M_PI * n / period;
+        switch (spec.type) {
+            case WindowType::Rectangular: out[n] = 1.0; break;
+            case WindowType::Hann: out[n] = 0.5 * (1 - std::cos(x)); break;
+            case WindowType::Hamming: out[n] = cosine_sum(kHamming, 2, x); break;
+            case WindowType::Blackman: out[n] = cosine_sum(kBlackman, 3, x); break;
+            case WindowType::BlackmanHarris: out[n] = cosine_sum(kBlackmanHarris, 4, x); break;
+            case WindowType::FlatTop: out[n] = cosine_sum(kFlatTop, 5, x); break;
+            case WindowType::Kaiser: {
+                double r = 2.0 * n / period - 1.0;
+                out[n] = bessel_i0(spec.beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / bessel_i0(spec.beta);
+                break;
+            }
+        }
+    }
+}
+
+typedef std::tuple<int, bool, double, int> WindowKey;  // type, periodic, beta, length
+
+std::mutex g_cache_mutex;
+std::map<WindowKey, std::shared_ptr<const WindowTable>> g_cache;
+
+} // namespace
+
+WindowType parse_window_type(const std::string& name) {
+    if (name == "rectangular" || name == "boxcar") return WindowType::Rectangular;
+    if (name == "hann") return WindowType::Hann;
+    if (name == "hamming") return WindowType::Hamming;
+    if (name == "blackman") return WindowType::Blackman;
+    if (name == "blackmanharris" || name == "blackman_harris") return WindowType::BlackmanHarris;
+    if (name == "kaiser") return WindowType::Kaiser;
+    if (name == "flattop") return WindowType::FlatTop;
+    throw std::invalid_argument("Unknown window: " + name);
+}
+
+const char* window_type_name(WindowType type) {
+    switch (type) {
+        case WindowType::Rectangular: return "rectangular";
+        case WindowType::Hamming: return "hamming";
+        case WindowType::Blackman: return "blackman";
+        case WindowType::BlackmanHarris: return "blackmanharris";
+        case WindowType::Kaiser: return "kaiser";
+        case WindowType::FlatTop: return "flattop";
+        default: return "hann";
+    }
+}
+
+WindowSpec make_window_spec(const std::string& name, bool periodic, double beta) {
+    WindowSpec spec;
+    spec.type = parse_window_type(name);
+    spec.periodic = periodic;
+    spec.beta = beta;
+    return spec;
+}
+
+WindowTable::WindowTable(const WindowSpec& spec, int length) : length_(length) {
+    if (length <= 0) throw std::invalid_argument("window length must be positive");
+    data_ = static_cast<double*>(fftw_malloc(sizeof(double) * length));  // SIMD-aligned
+    if (!data_) throw std::bad_alloc();
+    fill_window(spec, length, data_);
+}
+
+WindowTable::~WindowTable() {
+    fftw_free(data_);
+}
+
+std::shared_ptr<const WindowTable> get_window(const WindowSpec& spec, int length) {
+    // beta only distinguishes Kaiser windows
+    double beta = spec.type == WindowType::Kaiser ? spec.beta : 0.0;
+    WindowKey key(static_cast<int>(spec.type), spec.periodic, beta, length);
+
+    std::lock_guard<std::mutex> lock(g_cache_mutex);
+    std::shared_ptr<const WindowTable>& table = g_cache[key];
+    if (!table) table = std::make_shared<const WindowTable>(spec, length);
+    return table;
+}
+
+std::vector<double> window_samples(const WindowSpec& spec, int length) {
+    std::shared_ptr<const WindowTable> table = get_window(spec, length);
+    return std::vector<double>(table->data(), table->data() + table->size());
+}
@@ -12,6 +12,13 @@ spec = importlib.util.spec_from_file_location("audio_features", so_path)
 audio_features = importlib.util.module_from_spec(spec)
 spec.loader.exec_module(audio_features)
 
+# which SIMD paths the FFT runs on ('active' empty = scalar codelets only)
+report = audio_features.simd_report()
+print("FFTW", report["fftw_version"], "cpu:", report["cpu"], "built:", report["built"], "active:", report["active"])
+
+# record per-stage spans (decode, window, fft, mel, dct, python conversion), written out after the MFCCs
+audio_features.enable_trace(True)
+
 # Test with random signal (using std::vector, so must use python list, cannot accept numpy 1D array)
 #signal = [0.1, -0.2, 0.3, -0.4, 0.0, 0.5]
 # make this go get the 
@@ -60,7 +67,9 @@ for i in range(num_frames):
 print("================Start of Amplitude Spectrum==============================")
 # Compute amplitude spectrum
 stft = audio_features.compute_stft(signal, frame_size, hop_size)
-spectrogram = np.array(stft).T  # shape: [freq_bins, time_frames]
+# frequency-major rows come straight from the kernel, no transpose afterwards
+spectrogram = np.array(audio_features.compute_stft(signal, frame_size, hop_size, layout="frequency"))  # [bins, frames]
+print("frequency-major == transpose:", np.array_equal(spectrogram, np.array(stft).T))
 
 print("================Start Spectral Centroid==============================")
 # Compute Spectral Centroid
@@ -77,6 +86,50 @@ rolloff = audio_features.compute_spectral_rolloff(stft, sample_rate, frame_size,
 print("================Start of MFCC==============================")
 mfccs = audio_features.compute_mfcc(stft, sample_rate, frame_size, 26, 13)
 
+# power spectrum skips the sqrt; MFCCs from it are log mel power based (tell compute_mfcc what the rows hold)
+power = audio_features.compute_stft(signal, frame_size, hop_size, output="power")
+mfccs_power = audio_features.compute_mfcc(power, sample_rate, frame_size, 26, 13, spectrum="power")
+print("Power spectrum == magnitude^2:", np.allclose(np.array(power), np.array(stft) ** 2))
+
+# streaming loop without allocations: preallocated out= arrays are filled in place (NumPy input, no lists)
+signal_f32 = np.asarray(signal, dtype=np.float32)
+n_frames = len(stft)
+stft_out = np.empty((n_frames, frame_size // 2 + 1))
+centroid_out = np.empty(n_frames)
+mfcc_out = np.empty((n_frames, 13))
+for _ in range(3):
+    audio_features.compute_stft(signal_f32, frame_size, hop_size, out=stft_out)
+    audio_features.compute_spectral_centroid(stft_out, sample_rate, frame_size, out=centroid_out)
+    audio_features.compute_mfcc(stft_out, sample_rate, frame_size, 26, 13, out=mfcc_out)
+print("out= results identical:", np.array_equal(stft_out, np.array(stft)), np.array_equal(mfcc_out, np.array(mfccs)))
+mfcc_fm = np.empty((13, n_frames))
+audio_features.compute_mfcc(spectrogram, sample_rate, frame_size, 26, 13, layout="frequency", out=mfcc_fm)
+print("frequency-major MFCC == transpose:", np.array_equal(mfcc_fm, np.array(mfccs).T))
+
+# settings no STFT can frame raise ValueError on every path instead of returning an empty result
+for bad in [dict(win_len=0, hop_len=hop_size), dict(win_len=frame_size, hop_len=0),
+            dict(win_len=frame_size, hop_len=hop_size, n_fft=frame_size // 2)]:
+    for kwargs in [{}, {"out": stft_out}, {"output": "complex"}]:
+        try:
+            audio_features.compute_stft(signal_f32, **bad, **kwargs)
+        except ValueError:
+            continue
+        raise AssertionError(f"compute_stft{bad, kwargs} did not raise")
+print("invalid STFT settings raise ValueError")
+
+# log mel before the DCT for ML dumps: float16 / bfloat16 halve float32's footprint (bfloat16 comes back as uint16 bits)
+log_mel = audio_features.compute_log_mel(stft, sample_rate, frame_size, 64)
+log_mel_f16 = audio_features.compute_log_mel(stft, sample_rate, frame_size, 64, dtype="float16", normalize=True)
+log_mel_bf16 = audio_features.compute_log_mel(stft, sample_rate, frame_size, 64, dtype="bfloat16")
+bf16_as_f32 = (log_mel_bf16.astype(np.uint32) << 16).view(np.float32)
+print("log mel", log_mel.shape, log_mel.dtype, "| float16 normalized band means ~0:",
+      np.allclose(log_mel_f16.astype(np.float32).mean(axis=0), 0, atol=1e-2),
+      "| bfloat16 max rel err: %.1e" % np.max(np.abs(bf16_as_f32 - log_mel) / np.maximum(np.abs(log_mel), 1)))
+
+audio_features.enable_trace(False)
+dropped = audio_features.dump_trace("audio_features_trace.json")
+print("Trace written to audio_features_trace.json (dropped events: %d)" % dropped)
+
 # convert mfccs (python list of lists) to NumPy array
 mfccs_np = np.array(mfccs)
 
@@ -0,0 +1,71 @@
+# Stateful Extractor: build the plan, window and filterbank once, then reuse them for every clip
+import audio_features
+import numpy as np
+import time
+
+frame_size = 1024
+hop_size = 512
+
+signal, sample_rate = audio_features.get_wav_data("data/file_example_WAV_1MG.wav")
+signal = np.asarray(signal, dtype=np.float32)
+
+extractor = audio_features.Extractor(sample_rate, n_fft=frame_size, hop_len=hop_size, n_mel=26, n_mfcc=13)
+features = extractor.process(signal)
+print("Python says: frames", features["n_frames"], "spectrum", features["spectrum"].shape,
+      "mfcc", features["mfcc"].shape)
+
+# same numbers as the free functions
+stft = np.array(audio_features.compute_stft(signal.tolist(), frame_size, hop_size))
+mfcc = np.array(audio_features.compute_mfcc(stft.tolist(), sample_rate, frame_size, 26, 13))
+print("Python says: max |spectrum diff|", np.abs(features["spectrum"] - stft).max(),
+      "max |mfcc diff|", np.abs(features["mfcc"] - mfcc).max())
+
+# many short clips: only the compute is paid per call
+clip = signal[:sample_rate]
+start = time.perf_counter()
+for _ in range(100):
+    extractor.process(clip)
+print(f"Python says: {(time.perf_counter() - start) * 10:.3f} ms per 1 s clip")
+
+# block streaming gives the same frames as one call on the whole signal
+extractor.reset()
+blocks = [extractor.process_block(signal[i:i + 4096]) for i in range(0, len(signal), 4096)]
+mfcc_blocks = np.concatenate([b["mfcc"] for b in blocks])
+print("Python says: block frames", extractor.frames_emitted, "identical", np.array_equal(mfcc_blocks, features["mfcc"]))
+
+# only what you ask for
+small = audio_features.Extractor(sample_rate, features=["rms", "zcr", "centroid"]).process(signal)
+print("Python says: keys", sorted(small.keys()))
+
+# librosa-style framing: 2048-point FFT of 1024-sample windows, centered with reflect padding (no padded copy)
+centered = audio_features.Extractor(sample_rate, n_fft=2048, win_len=1024, hop_len=hop_size, center=True,
+                                    pad_mode="reflect", features=["spectrum", "mfcc"])
+full = centered.process(signal)
+stft_centered = np.array(audio_features.compute_stft(signal.tolist(), 1024, hop_size, n_fft=2048, center=True,
+                                                     pad_mode="reflect"))
+print("Python says: centered frames", full["n_frames"], "expected", 1 + len(signal) // hop_size,
+      "max |diff|", np.abs(full["spectrum"] - stft_centered).max())
+
+# streaming needs flush() for the right-padded frames at the end
+parts = [centered.process_block(signal[i:i + 4096])["spectrum"] for i in range(0, len(signal), 4096)]
+parts.append(centered.flush()["spectrum"])
+print("Python says: centered blocks identical", np.array_equal(np.concatenate(parts), full["spectrum"]))
+
+# window registry: tables are cached per (type, length, periodic, beta) and shared by every extractor
+for name in ["hann", "hamming", "blackman", "blackmanharris", "kaiser", "flattop"]:
+    w = np.array(audio_features.get_window(name, 1024, periodic=True))
+    ex = audio_features.Extractor(sample_rate, n_fft=1024, hop_len=hop_size, window=name, periodic=True,
+                                  features=["centroid"])
+    print(f"Python says: {name:15s} sum {w.sum():8.2f}  mean centroid {ex.process(signal)['centroid'].mean():8.1f} Hz")
+
+# a batch of clips in one call: rows of a 2-D array, lengths mark the valid samples of each row
+clips = np.stack([signal[i * sample_rate // 4:i * sample_rate // 4 + sample_rate] for i in range(256)])
+lengths = [sample_rate - (i % 4) * sample_rate // 8 for i in range(256)]
+start = time.perf_counter()
+batch = extractor.process_batch(clips, lengths)
+batch_ms = (time.perf_counter() - start) * 1000
+start = time.perf_counter()
+single = [extractor.process(clip[:n]) for clip, n in zip(clips, lengths)]
+single_ms = (time.perf_counter() - start) * 1000
+print(f"Python says: batch mfcc {batch['mfcc'].shape} in {batch_ms:.1f} ms, per clip {single_ms:.1f} ms, identical",
+      all(np.array_equal(batch["mfcc"][i, :batch["n_frames"][i]], s["mfcc"]) for i, s in enumerate(single)))
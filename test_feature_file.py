@@ -0,0 +1,41 @@
+# Columnar feature file instead of pickled lists: chunked columns, appendable, read back through mmap
+import audio_features
+import numpy as np
+import os
+import pickle
+import tempfile
+import time
+
+signal, sample_rate = audio_features.get_wav_data("data/file_example_WAV_1MG.wav")
+signal = np.asarray(signal, dtype=np.float32)
+extractor = audio_features.Extractor(sample_rate, n_fft=1024, hop_len=512)
+features = extractor.process(signal)
+
+out_dir = tempfile.mkdtemp()
+path = os.path.join(out_dir, "features.afeat")
+
+start = time.perf_counter()
+with audio_features.FeatureFileWriter(path, extractor, chunk_frames=256) as writer:
+    writer.write(features)
+write_ms = (time.perf_counter() - start) * 1000
+
+start = time.perf_counter()
+with open(os.path.join(out_dir, "features.pkl"), "wb") as f:
+    pickle.dump({"spectrum": features["spectrum"].tolist(), "mfcc": features["mfcc"].tolist()}, f)
+pickle_ms = (time.perf_counter() - start) * 1000
+print(f"Python says: feature file {os.path.getsize(path) / 1e6:.1f} MB in {write_ms:.1f} ms, "
+      f"pickled lists {os.path.getsize(os.path.join(out_dir, 'features.pkl')) / 1e6:.1f} MB in {pickle_ms:.1f} ms")
+
+# append a second clip, then read arbitrary frame ranges without loading the file
+with audio_features.FeatureFileWriter(path, extractor, append=True) as writer:
+    writer.write(features)
+
+store = audio_features.FeatureFile(path)
+n = features["n_frames"]
+print("Python says: frames", store.n_frames, "columns", store.columns, "matches extractor", store.matches(extractor))
+view = store.read("mfcc", 10, 20)
+print("Python says: view", view.shape, "read-only", not view.flags.writeable,
+      "identical", np.array_equal(view, features["mfcc"][10:20]))
+across = store.read("spectrum", n - 5, n + 5)  # spans the two writes, comes back as a copy
+print("Python says: across chunks identical",
+      np.array_equal(across, np.concatenate([features["spectrum"][-5:], features["spectrum"][:5]])))
@@ -0,0 +1,24 @@
+# One long file through the decode -> features -> write pipeline: memory stays flat however long the file is
+import audio_features
+import numpy as np
+import os
+import tempfile
+import time
+
+path = "data/file_example_WAV_1MG.wav"
+extractor = audio_features.Extractor(44100, n_fft=1024, hop_len=512, center=True, pad_mode="reflect")
+
+out_dir = tempfile.mkdtemp()
+start = time.perf_counter()
+stats = audio_features.extract_file_to_npy(path, out_dir, extractor, segment_frames=256, n_workers=2)
+print(f"Python says: {stats['n_frames']} frames in {stats['segments']} segments, "
+      f"{(time.perf_counter() - start) * 1000:.1f} ms, {stats['buffer_bytes'] / 1e6:.1f} MB of buffers")
+print("Python says: wrote", [os.path.basename(p) for p in stats["paths"]])
+
+# same frames as the whole file in one call (for a mono file; multichannel files are averaged first)
+if stats["channels"] == 1:
+    signal, sample_rate = audio_features.get_wav_data(path)
+    whole = audio_features.Extractor(sample_rate, n_fft=1024, hop_len=512, center=True,
+                                     pad_mode="reflect").process(np.asarray(signal, dtype=np.float32))
+    for name in ("spectrum", "mfcc", "rms"):
+        print("Python says:", name, "identical", np.array_equal(np.load(os.path.join(out_dir, name + ".npy")), whole[name]))
@@ -0,0 +1,52 @@
+# Complex STFT -> spectral processing -> inverse STFT, all in C++
+import audio_features
+import numpy as np
+import time
+
+n_fft = 1024
+hop_size = 256
+
+signal, sample_rate = audio_features.get_wav_data("data/file_example_WAV_1MG.wav")
+signal = np.asarray(signal, dtype=np.float64)
+duration = len(signal) / sample_rate
+
+# periodic Hann with hop <= n_fft // 2 reconstructs exactly
+stft = audio_features.compute_stft_complex(signal, n_fft, hop_size, center=True, pad_mode="reflect", periodic=True)
+print("Python says: stft", stft.shape, stft.dtype)
+
+start = time.perf_counter()
+resynth = audio_features.compute_istft(stft, n_fft, hop_size, center=True, periodic=True, length=len(signal))
+elapsed = time.perf_counter() - start
+print(f"Python says: round trip max error {np.abs(resynth - signal).max():.2e}, "
+      f"istft {elapsed * 1000:.2f} ms ({duration / elapsed:.0f}x realtime)")
+
+# spectral masking: zero everything above 4 kHz
+masked = stft.copy()
+masked[:, int(4000 / (sample_rate / n_fft)):] = 0
+lowpassed = audio_features.compute_istft(masked, n_fft, hop_size, center=True, periodic=True, length=len(signal))
+print("Python says: lowpassed rms", np.sqrt(np.mean(lowpassed ** 2)), "original rms", np.sqrt(np.mean(signal ** 2)))
+
+# block streaming gives the same samples as the batch call
+istft = audio_features.InverseStft(n_fft, hop_size, center=True, periodic=True)
+blocks = [istft.process(stft[i:i + 7]) for i in range(0, len(stft), 7)]
+blocks.append(istft.flush(trim_padding=False))
+streamed = np.concatenate(blocks)[:len(signal)]
+print("Python says: streamed == batch:", np.array_equal(streamed, resynth[:len(streamed)]))
+
+# streaming analysis: uneven blocks (like capture callbacks) give compute_stft_complex's frames, bit for bit
+stream = audio_features.StreamingSTFT(n_fft, hop_size, center=True, pad_mode="reflect", periodic=True,
+                                      output="complex")
+rng = np.random.default_rng(0)
+frames, pos = [], 0
+start = time.perf_counter()
+while pos < len(signal):
+    block = int(rng.integers(1, 4096))
+    first, new = stream.push(signal[pos:pos + block])
+    assert first == sum(len(f) for f in frames)
+    frames.append(new)
+    pos += block
+frames.append(stream.flush()[1])
+elapsed = time.perf_counter() - start
+streamed_stft = np.concatenate(frames)
+print(f"Python says: streaming stft {streamed_stft.shape}, == batch: {np.array_equal(streamed_stft, stft)}, "
+      f"{elapsed * 1000:.2f} ms ({duration / elapsed:.0f}x realtime)")
@@ -7,8 +7,16 @@ sample_rate = 48000
 hop_size = 512
 frame_size = 1024
 
-# Start streaming (e.g., 48000 Hz, 512 frames per buffer)
-audio_features.start_streaming(sample_rate, hop_size)
+# Compute features in C++ on a worker thread, one frame per hop
+audio_features.enable_stream_features(frame_size, hop_size)
+
+for dev in audio_features.list_input_devices():
+    print(f"Device #{dev.index}: {dev.name} ({dev.host_api}), {dev.max_input_channels} ch"
+          f"{' [default]' if dev.is_default else ''}")
+
+# Start streaming (e.g., 48000 Hz, 512 frames per buffer) on the default input,
+# asking for exactly the mono 16-bit stream we analyze (negotiated against the device)
+audio_features.start_streaming(sample_rate, hop_size, device=None, channels=1, sample_format="int16")
 
 print("Python says: Streaming started...")
 
@@ -28,8 +36,15 @@ for _ in range(3):
     #   break
 
 
+feature_frames = audio_features.get_feature_frames()
+
 audio_features.stop_streaming()
 
+print(f"Python says: Received {len(feature_frames)} feature frames")
+for f in feature_frames[:5]:
+    print(f"  frame {f.index} t={f.timestamp:.3f}s latency={f.latency * 1000:.2f}ms "
+          f"rms={f.rms:.4f} zcr={f.zcr:.4f} centroid={f.centroid:.1f}Hz")
+
 print("Python says: Streaming stopped.")
 print(buffer[:100])  # print first 100 samples
 
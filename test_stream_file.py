@@ -0,0 +1,54 @@
+# Headless streaming test: play a WAV file through the capture callback path instead of a microphone
+import audio_features
+import time
+
+frame_size = 1024
+hop_size = 512
+
+audio_features.enable_stream_features(frame_size, hop_size)
+
+# realtime=False runs as fast as the frames are drained (lossless), realtime=True paces buffers like a real device
+audio_features.start_streaming_file("data/file_example_WAV_1MG.wav", frames_per_buffer=hop_size,
+                                    realtime=True, jitter_ms=2.0, xrun_probability=0.01, seed=1)
+
+frames = []
+while audio_features.is_streaming():
+    frames += audio_features.get_feature_frames()
+    time.sleep(0.1)
+
+audio_features.stop_streaming()
+frames += audio_features.get_feature_frames()
+
+stats = audio_features.get_stream_stats()
+print("Python says: stats", stats)
+print(f"Python says: {len(frames)} feature frames")
+
+if frames:
+    latencies = sorted(f.latency for f in frames)
+    print(f"Python says: median latency {latencies[len(latencies) // 2] * 1000:.3f} ms, "
+          f"max {latencies[-1] * 1000:.3f} ms")
+
+# Independent sessions: each AudioStreamer owns its ring buffer and feature pipeline.
+# realtime=False waits for the feature engine and for get_feature_frames() instead of dropping, so the
+# result is exact: one frame per hop over the whole file, nothing dropped
+sessions = []
+for win, hop in [(1024, 512), (2048, 256)]:
+    s = audio_features.AudioStreamer(frames_per_buffer=256)
+    s.enable_features(win_len=win, hop_len=hop)
+    s.start_file("data/file_example_WAV_1MG.wav", realtime=False)
+    sessions.append((s, win, hop, []))
+
+while any(s.is_running() for s, _, _, _ in sessions):
+    for s, _, _, frames in sessions:
+        frames += s.get_feature_frames()
+    time.sleep(0.01)
+
+for s, win, hop, frames in sessions:
+    s.stop()
+    frames += s.get_feature_frames()
+    stats = s.stats()
+    n = stats["frames"]
+    print(f"Python says: session @ {s.sample_rate} Hz -> {len(frames)} frames, stats {stats}")
+    assert stats["dropped_samples"] == 0 and stats["dropped_frames"] == 0, stats
+    assert len(frames) == (n - win) // hop + 1, (len(frames), n, win, hop)
+    assert [f.index for f in frames] == list(range(len(frames)))
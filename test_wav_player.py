@@ -7,10 +7,28 @@ import wav_player # imports the built .so file and whatever else you put in that
     # include/ (all files here)
     # find_package and target_link_libraries tell this to find pybind11 and link it (figure out what linking is)
     # (everything from add_library and target_include_directories in the CMake file)
+import time
 
 # Call the function defined in C++ to play a .wav file
 # Make sure the path points to a real WAV file
 wav_player.play_wav_file("data/file_example_WAV_1MG.wav")
 
+# Non-blocking playback: play/pause/seek return immediately
+player = wav_player.WavPlayer("data/file_example_WAV_1MG.wav")
+print(f"duration {player.duration:.2f}s, {player.sample_rate} Hz, {player.channels} ch")
 
-# when you run CMakeLists.txt it creates a .so file (shared object file)
\ No newline at end of file
+player.seek(5.0)
+player.play()
+time.sleep(1.0)
+print(f"position {player.position:.2f}s")
+
+player.seek(1.0)   # jump back while playing
+time.sleep(1.0)
+player.pause()
+print(f"paused at {player.position:.2f}s")
+
+player.stop()
+player.close()
+
+
+# when you run CMakeLists.txt it creates a .so file (shared object file)